@@ -0,0 +1,84 @@
+#ifndef APU_H
+#define APU_H
+
+/* Project Headers */
+#include "global.h"
+#include "savestate.h"
+
+/* APU Register Definitions */
+#define APU_REG_DMC_CONTROL                 (U16)(0x4010)
+#define APU_REG_DMC_LENGTH                  (U16)(0x4013)
+#define APU_REG_STATUS                      (U16)(0x4015)
+#define APU_REG_FRAME_COUNTER               (U16)(0x4017)
+
+/* APU Timing Definitions (NTSC, CPU cycles) */
+#define APU_FRAME_IRQ_FIRST                 (U32)(29829)    /* From a $4017 write to the first frame IRQ */
+#define APU_FRAME_IRQ_PERIOD                (U32)(29830)    /* 4-step sequence length */
+#define APU_NEVER                           (U64)(0xFFFFFFFFFFFFFFFF)
+
+
+namespace APUFlags
+{
+    /* Constant Expressions: DMC control ($4010) */
+    constexpr U8 DMC_RATE                   = 0x0F; /* BIT0-3: Rate index */
+    constexpr U8 DMC_LOOP                   = 0x40; /* BIT6: Loop the sample */
+    constexpr U8 DMC_IRQ_ENABLE             = 0x80; /* BIT7: IRQ at the end of the sample */
+    /* Constant Expressions: Status ($4015) */
+    constexpr U8 STATUS_DMC_ACTIVE          = 0x10; /* BIT4: Write: start/stop the DMC, read: sample bytes remaining */
+    constexpr U8 STATUS_FRAME_IRQ           = 0x40; /* BIT6: Frame counter IRQ (read clears) */
+    constexpr U8 STATUS_DMC_IRQ             = 0x80; /* BIT7: DMC IRQ */
+    /* Constant Expressions: Frame counter ($4017) */
+    constexpr U8 FRAME_IRQ_INHIBIT          = 0x40; /* BIT6: Inhibit the frame IRQ */
+    constexpr U8 FRAME_MODE_5STEP           = 0x80; /* BIT7: 5-step sequence (no IRQ) */
+}
+
+
+/**
+ * The interrupt sources of the APU: the frame counter IRQ and the DMC end of
+ * sample IRQ. No audio is generated.
+ *
+ * Instead of being clocked, the APU reports the CPU cycle of its next IRQ so
+ * the bus can schedule it, and the bus calls back when that cycle is reached.
+ */
+class APU
+{
+    private:
+        /* Frame counter */
+        U8 frameControl;        /* Last $4017 write */
+        bool frameIRQ;
+        U64 frameIRQCycle;      /* Next frame IRQ (APU_NEVER: none) */
+
+        /* DMC */
+        U8 dmcControl;          /* Last $4010 write */
+        U8 dmcLength;           /* Last $4013 write */
+        bool dmcIRQ;
+        U64 dmcEndCycle;        /* End of the playing sample (APU_NEVER: idle) */
+
+        U64 sampleCycles(void);
+
+    public:
+        APU();
+        ~APU();
+
+        void reset(U64 cpuCycle);
+
+        /* CPU facing registers */
+        void writeRegister(U16 addr, U8 data, U64 cpuCycle);
+        U8 readStatus(U64 cpuCycle);
+
+        /* Scheduled callbacks */
+        void frameCounterEvent(void);
+        void dmcEvent(void);
+
+        /* Save states */
+        void saveState(StateWriter& state);
+        void loadState(StateReader& state);
+
+        /* Assessors */
+        inline bool isIRQAsserted(void) { return frameIRQ || dmcIRQ; }
+        inline U64 getFrameIRQCycle(void) { return frameIRQCycle; }
+        inline U64 getDMCEndCycle(void) { return dmcEndCycle; }
+};
+
+
+#endif /* APU_H */
\ No newline at end of file
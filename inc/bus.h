@@ -1,22 +1,126 @@
-#ifndef BUS_H
-#define BUS_H
-
-#include <memory>
-#include "global.h"
-#include "nesmemory.h"
-
-class Bus
-{
-    private:
-        std::unique_ptr<NESMemory> nes_memory;
-
-    public:
-        Bus();
-        ~Bus();
-
-        void writeToBus(U16 addr, U8 data);
-        U8 readFromBus(U16 addr);
-};
-
-
+#ifndef BUS_H
+#define BUS_H
+
+#include <array>
+#include <memory>
+#include "apu.h"
+#include "dirtypages.h"
+#include "global.h"
+#include "instancearena.h"
+#include "nesmemory.h"
+#include "ppupipeline.h"
+#include "rp2c02.h"
+#include "savestate.h"
+#include "scheduler.h"
+
+/* Forward Declarations */
+class RP2A03;
+
+/* Scanline IRQ Definitions */
+#define BUS_NO_SCANLINE_IRQ                 (U16)(0xFFFF)
+#define BUS_SCANLINE_IRQ_DOT                (U16)(260)      /* Dot at which cartridge scanline counters are clocked */
+
+class Bus
+{
+    private:
+        /* Allocated from the instance arenas, so clones make no heap calls */
+        InstanceArena<NESMemory>::Pointer nes_memory;
+        InstanceArena<RP2C02>::Pointer ppu;
+        std::unique_ptr<PPURenderPipeline> renderPipeline;
+
+        /* Standard controllers on $4016/$4017 */
+        std::array<U8, 2> controllerState;  /* Buttons held (BIT0: A, B, Select, Start, Up, Down, Left, BIT7: Right) */
+        std::array<U8, 2> controllerShift;  /* Serial shift registers */
+        bool controllerStrobe;
+
+        /* OAM DMAs started by the current instruction */
+        U8 pendingDMA;
+
+        /* CPU driving the bus (not owned); its cycle count is the bus time */
+        RP2A03* cpu;
+
+        /* Devices are not clocked with the CPU: the PPU catches up when it is
+           accessed or an event is due, interrupt sources schedule their next firing */
+        U64 ppuSyncCycle;   /* CPU cycle the PPU has been clocked up to */
+        EventScheduler scheduler;
+        U64 vblankFrame;    /* PPU frame count the scheduled vblank will end */
+        APU apu;
+
+        /* Interrupt lines */
+        bool nmiPending;    /* Edge-triggered: latched on a rising NMI output until taken */
+        bool mapperIRQ;     /* Level: held until the cartridge acknowledges it */
+        U16 scanlineIRQ;    /* Scanline of the pending cartridge IRQ (BUS_NO_SCANLINE_IRQ: none) */
+
+        void oamDMA(U8 page);
+        U64 getCPUCycle(void);
+        void scheduleVBlank(void);
+        void scheduleAPU(void);
+        void scheduleScanline(void);
+        void saveBusState(StateWriter& state);
+        void loadBusState(StateReader& state);
+
+        /* State pages written since the last collectDirtyPages() */
+        DirtyPages dirtyPages;
+
+    public:
+        Bus();
+        Bus(const Bus& other);
+        Bus& operator=(const Bus&) = delete;
+        ~Bus();
+
+        void writeToBus(U16 addr, U8 data);
+        U8 readFromBus(U16 addr);
+
+        /* CPU cycles the DMAs of the last instruction halt the CPU for, given the
+           cycle count after it (513, plus one to align to an odd cycle) */
+        U16 takeDMAStall(U64 cpuCycles);
+
+        /* Clocks the PPU up to the CPU's cycle count (3 dots per cycle) */
+        void syncPPU(void);
+
+        /* Power-up state of the PPU, APU and interrupt lines, timed from the CPU's cycle count */
+        void reset(void);
+
+        /* Event timeline */
+        U64 getNextEventCycle(void);    /* CPU cycle at which the next event is due */
+        void runEvents(void);           /* Handles every event due at the CPU's cycle count */
+
+        /* Interrupt lines */
+        bool takeNMI(void);
+        inline bool isIRQAsserted(void) { return apu.isIRQAsserted() || mapperIRQ; }
+        inline bool isNMIPending(void) { return nmiPending; }
+
+        /* Cartridge scanline counters (e.g. MMC3): raise the IRQ line at dot 260 of a scanline */
+        void setScanlineIRQ(U16 scanline);
+        void acknowledgeScanlineIRQ(void);
+
+        void insertCartridge(std::shared_ptr<const Cartridge> cart);
+
+        /* Save states */
+        void saveState(StateWriter& state);
+        void loadState(StateReader& state);
+        void saveRegisters(StateWriter& state);
+        void loadRegisters(StateReader& state);
+
+        /* Dirty page tracking: returns the pages written since the last call and clears them */
+        DirtyPages collectDirtyPages(void);
+        U8* getStatePage(U16 page);
+
+        /* Moves pixel generation onto a render worker thread (resync it after restoring the PPU by hand) */
+        void setPipelinedRendering(bool enable);
+        void syncRenderPipeline(void);
+
+        /* Assessors */
+        inline RP2C02* getPPU(void) { return ppu.get(); }
+        inline NESMemory* getMemory(void) { return nes_memory.get(); }
+        inline bool isPipelined(void) { return renderPipeline != nullptr; }
+
+        /* Modifiers */
+        inline void connectCPU(RP2A03* processor) { cpu = processor; }
+        inline void setControllerState(U8 port, U8 buttons) { controllerState[port & 0x01] = buttons; }
+        inline void markDirty(U16 page) { dirtyPages.mark(page); }
+        inline void markAllDirty(void) { dirtyPages.markAll(); }
+};
+
+
 #endif /* BUS_H */
\ No newline at end of file
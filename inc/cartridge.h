@@ -0,0 +1,44 @@
+#ifndef CARTRIDGE_H
+#define CARTRIDGE_H
+
+/* Standard Headers */
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+/* Project Headers */
+#include "global.h"
+
+/* iNES Definitions */
+#define INES_HEADER_SIZE                    (size_t)(16)
+#define INES_TRAINER_SIZE                   (size_t)(512)
+#define INES_PRG_BANK_SIZE                  (size_t)(0x4000)
+#define INES_CHR_BANK_SIZE                  (size_t)(0x2000)
+
+
+/* Nametable mirroring arrangement (set by the cartridge) */
+enum class Mirroring
+{
+    horizontal, vertical, fourScreen
+};
+
+
+/**
+ * Read-only cartridge contents. Every console running the same game shares one
+ * Cartridge through a std::shared_ptr<const Cartridge>, so PRG/CHR ROM is never
+ * part of the per-instance state.
+ */
+struct Cartridge
+{
+    std::vector<U8> prgRom;     /* 16 KB or 32 KB, mapped at 0x8000 - 0xFFFF */
+    std::vector<U8> chrRom;     /* 8 KB, or empty when the board has CHR RAM instead */
+    Mirroring mirroring;
+};
+
+
+/* iNES loaders: return nullptr for malformed images and unsupported mappers */
+std::shared_ptr<const Cartridge> loadINES(const U8* data, size_t size);
+std::shared_ptr<const Cartridge> loadINESFile(const std::string& path);
+
+
+#endif /* CARTRIDGE_H */
\ No newline at end of file
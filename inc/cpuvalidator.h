@@ -0,0 +1,142 @@
+#ifndef CPU_VALIDATOR_H
+#define CPU_VALIDATOR_H
+
+/* Standard Headers */
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+/* Project Headers */
+#include "cartridge.h"
+#include "global.h"
+#include "instancearena.h"
+#include "nes.h"
+#include "rp2a03lockstep.h"
+
+/* Validator Definitions */
+#define VALIDATOR_NO_LANE                   (U32)(0xFFFFFFFF)
+#define VALIDATOR_NO_ADDR                   (U32)(0xFFFFFFFF)
+#define VALIDATOR_FUZZ_INSTRUCTIONS         (U64)(100000)     /* Default run per fuzz seed */
+#define VALIDATOR_FUZZ_BLOCK                (U32)(64)         /* Instructions between comparisons while fuzzing */
+
+
+/* Register file of one CPU engine */
+struct CPURegisters
+{
+    U16 PC;
+    U8 SP;
+    U8 A;
+    U8 X;
+    U8 Y;
+    U8 status;
+    U64 cycles;
+};
+
+
+/* First mismatch found between the engines */
+struct CPUDivergence
+{
+    U64 instruction;        /* Instructions executed before the diverging one */
+    U32 lane;               /* VALIDATOR_NO_LANE: no divergence */
+    U8 opCode;
+    U8 operandBytes[2];     /* The two bytes after the opcode */
+    CPURegisters before;    /* Registers both engines agreed on */
+    CPURegisters reference;
+    CPURegisters candidate;
+    U32 ramAddr;            /* First differing internal RAM byte (VALIDATOR_NO_ADDR: RAM matches) */
+    U8 referenceByte;
+    U8 candidateByte;
+
+    std::string report(void) const;
+};
+
+
+/**
+ * Runs the reference interpreter (RP2A03::CPU_Cycle) and the lockstep engine
+ * (RP2A03Lockstep) side by side on the same state and stops at the first
+ * instruction where their registers or internal RAM differ.
+ *
+ * Every lane has a reference console and a device console: the lockstep lane
+ * reads I/O through the device console's bus, whose CPU cycle count is kept in
+ * step with the lane, so PPU and APU side effects match the reference's.
+ *
+ * With a block length above one the engines are only compared at the end of
+ * each block; on a mismatch both are rewound to the block's checkpoint and the
+ * block is replayed one instruction at a time to find the exact instruction.
+ *
+ * Only registers, cycle counts and the 2 KB of internal RAM are compared. Bus
+ * writes outside internal RAM (PPU, APU, cartridge) are not recorded, so a
+ * difference there only shows up once it feeds back into registers or RAM.
+ * The lockstep engine has no store path yet (stores are stubs in RP2A03 too).
+ */
+class LockstepValidator
+{
+    private:
+        std::shared_ptr<const Cartridge> cartridge;
+        U32 laneCount;
+
+        std::vector<InstanceArena<NES>::Pointer> reference;
+        std::vector<InstanceArena<NES>::Pointer> devices;
+        std::unique_ptr<RP2A03Lockstep> candidate;
+
+        U64 instructionCount;
+        CPUDivergence divergence;
+
+        void loadCandidate(U32 lane);
+        void stepEngines(void);
+        bool lanesMatch(U32* lane, U32* ramAddr);
+        U8 peek(U32 lane, U16 addr);
+        void recordDivergence(U32 lane, U32 ramAddr, const CPURegisters& before, U64 instruction);
+        bool runBlock(U64 instructions, bool compareEach);
+
+    public:
+        LockstepValidator(std::shared_ptr<const Cartridge> cart, U32 lanes = LOCKSTEP_LANES);
+        ~LockstepValidator();
+
+        /* Copies every reference console into its lockstep lane; call after changing the references */
+        void syncLanes(void);
+
+        /* Runs up to instructions instructions, comparing every blockLength; false on divergence */
+        bool run(U64 instructions, U32 blockLength = 1);
+
+        /* Assessors */
+        inline U32 getLaneCount(void) { return laneCount; }
+        inline NES* getReference(U32 lane) { return reference[lane].get(); }
+        inline RP2A03Lockstep* getCandidate(void) { return candidate.get(); }
+        inline U64 getInstructionCount(void) { return instructionCount; }
+        inline bool hasDiverged(void) { return divergence.lane != VALIDATOR_NO_LANE; }
+        inline const CPUDivergence& getDivergence(void) { return divergence; }
+};
+
+
+/**
+ * Random programs and machine states for LockstepValidator.
+ *
+ * Programs are streams of documented opcodes, each followed by random operand
+ * bytes; operands are biased towards internal RAM so loads and stores hit
+ * memory both engines model, with a share of I/O and ROM addresses mixed in.
+ */
+class InstructionFuzzer
+{
+    private:
+        std::mt19937_64 random;
+        std::vector<U8> opCodes;    /* Documented opcodes of the instruction vector */
+
+        U8 randomByte(void);
+        U8 randomAddressHigh(void);
+
+    public:
+        InstructionFuzzer(U64 seed);
+
+        /* 32 KB PRG ROM holding a random instruction stream */
+        std::shared_ptr<const Cartridge> generateCartridge(void);
+
+        /* Random registers and internal RAM */
+        void randomizeConsole(NES& console);
+
+        /* Fresh cartridge and lane states, then runs until divergence or the instruction count */
+        bool fuzz(U32 lanes, U64 instructions, CPUDivergence* divergence);
+};
+
+
+#endif /* CPU_VALIDATOR_H */
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef DIRTY_PAGES_H
+#define DIRTY_PAGES_H
+
+/* Standard Headers */
+#include <array>
+/* Project Headers */
+#include "global.h"
+
+/* State Page Definitions: the bulk memory of a console, in 256-byte pages */
+#define STATE_PAGE_SIZE                     (U16)(0x0100)
+#define STATE_PAGE_RAM                      (U16)(0)    /* CPU RAM (8 pages) */
+#define STATE_PAGE_SRAM                     (U16)(8)    /* SRAM (32 pages) */
+#define STATE_PAGE_NAMETABLE                (U16)(40)   /* Name and attribute tables (16 pages) */
+#define STATE_PAGE_OAM                      (U16)(56)   /* Object attribute memory (1 page) */
+#define STATE_PAGE_CHR_RAM                  (U16)(57)   /* CHR RAM, boards without CHR ROM only (32 pages) */
+#define STATE_PAGE_COUNT                    (U16)(89)
+
+
+/**
+ * One bit per state page, set when the page is written. Consumers (e.g.
+ * StateTracker) collect and clear the bits to find what changed.
+ */
+class DirtyPages
+{
+    private:
+        std::array<U64, (STATE_PAGE_COUNT + 63) / 64> bits;
+
+    public:
+        DirtyPages() { markAll(); }
+
+        inline void mark(U16 page) { bits[page >> 6] |= (U64)1 << (page & 0x3F); }
+        inline bool test(U16 page) const { return (bits[page >> 6] >> (page & 0x3F)) & 0x01; }
+        inline void markAll(void) { bits.fill(~(U64)0); }
+        inline void clear(void) { bits.fill(0); }
+
+        inline DirtyPages& operator|=(const DirtyPages& other)
+        {
+            for(size_t i = 0; i < bits.size(); i++)
+            {
+                bits[i] |= other.bits[i];
+            }
+
+            return *this;
+        }
+
+        /* Calls fn(page) for every dirty page in ascending order */
+        template<typename Fn>
+        inline void forEach(Fn fn) const
+        {
+            for(size_t i = 0; i < bits.size(); i++)
+            {
+                U64 word = bits[i];
+                while(word)
+                {
+                    U16 page = static_cast<U16>(i * 64 + __builtin_ctzll(word));
+                    if(page < STATE_PAGE_COUNT)
+                    {
+                        fn(page);
+                    }
+
+                    word &= word - 1;
+                }
+            }
+        }
+};
+
+
+#endif /* DIRTY_PAGES_H */
\ No newline at end of file
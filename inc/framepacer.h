@@ -0,0 +1,111 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+/* Standard Headers */
+#include <array>
+#include <chrono>
+#include <mutex>
+/* Project Headers */
+#include "global.h"
+
+/* Frame Pacer Definitions */
+#define PACER_NTSC_HZ                       (double)(60.0988)   /* 39375000 / 655171 */
+#define PACER_PAL_HZ                        (double)(50.007)
+#define PACER_MIN_SPIN_US                   (U32)(200)          /* Busy-wait at least this long before a deadline */
+#define PACER_MAX_SPIN_US                   (U32)(4000)
+#define PACER_MAX_LAG_FRAMES                (U32)(3)            /* Further behind than this drops the backlog */
+#define PACER_HISTOGRAM_BINS                (U32)(64)
+#define PACER_HISTOGRAM_BIN_US              (U32)(100)          /* 0 - 6.4 ms, then an overflow bin */
+
+
+/* Video timing the pacer follows */
+enum class VideoStandard
+{
+    NTSC, PAL
+};
+
+
+/* Fixed-width histogram of durations in microseconds */
+struct LatencyHistogram
+{
+    std::array<U64, PACER_HISTOGRAM_BINS> bins;
+    U64 overflow;       /* Samples of PACER_HISTOGRAM_BINS * PACER_HISTOGRAM_BIN_US or more */
+    U64 count;
+    U64 totalUs;
+    U64 maxUs;
+
+    void clear(void);
+    void record(U64 us);
+    U64 percentile(double p) const;     /* Upper edge of the bin holding the p-th percentile (0 - 1) */
+    inline U64 meanUs(void) const { return count ? totalUs / count : 0; }
+};
+
+
+/* Counters and histograms since the last resetMetrics() */
+struct PacerMetrics
+{
+    U64 frames;
+    U64 lateFrames;             /* Emulation finished after the frame's deadline */
+    U64 resyncs;                /* Deadline reset after falling PACER_MAX_LAG_FRAMES behind */
+    LatencyHistogram emulation; /* Time between waking up (or restart()) and the next waitForNextFrame() */
+    LatencyHistogram overshoot; /* How far the OS sleep woke up past its target, for frames that slept */
+    LatencyHistogram jitter;    /* Distance of each frame interval from the nominal period (not on a grid's first frame) */
+};
+
+
+/**
+ * Paces the interactive build to the console's refresh rate.
+ *
+ * Deadlines are absolute (start + n * period), so early and late wake-ups don't
+ * add up to drift. Each wait sleeps until a spin margin before the deadline and
+ * busy-waits the rest. The margin follows the observed sleep overshoot, so the
+ * pacer only spins as long as the OS scheduler needs.
+ *
+ * There is no audio sync: the APU generates no samples, so there is no output
+ * buffer to follow.
+ *
+ * The metrics can be read from another thread while the pacer runs.
+ */
+class FramePacer
+{
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        double nominalHz;
+        Clock::duration period;
+        Clock::time_point deadline;
+        Clock::time_point lastWake;
+        bool started;
+
+        U64 spinUs;                 /* Current spin margin */
+        U64 sleepOvershootUs;       /* Moving average of the sleep's overshoot */
+
+        PacerMetrics metrics;
+        mutable std::mutex metricsLock;
+
+        bool sleepUntil(Clock::time_point target, U64* overshootUs);
+
+    public:
+        FramePacer(VideoStandard standard = VideoStandard::NTSC);
+        ~FramePacer();
+
+        /* Blocks until the next frame is due; call once per emulated frame */
+        void waitForNextFrame(void);
+
+        /* Forgets the current deadline, e.g. after a pause */
+        void restart(void);
+
+        /* Metrics */
+        PacerMetrics getMetrics(void) const;
+        void resetMetrics(void);
+
+        /* Assessors */
+        inline double getRefreshRate(void) { return nominalHz; }
+
+        /* Modifiers */
+        void setRefreshRate(double hz);
+        void setStandard(VideoStandard standard);
+};
+
+
+#endif /* FRAME_PACER_H */
\ No newline at end of file
@@ -1,12 +1,14 @@
-#ifndef GLOBAL_H
-#define GLOBAL_H
-
-/* Standard Headers */
-#include <cstdint>
-/* Project Headers */
-
-/* Type aliases */
-using U8 = uint8_t;
-using U16 = uint16_t;
-
+#ifndef GLOBAL_H
+#define GLOBAL_H
+
+/* Standard Headers */
+#include <cstdint>
+/* Project Headers */
+
+/* Type aliases */
+using U8 = uint8_t;
+using U16 = uint16_t;
+using U32 = uint32_t;
+using U64 = uint64_t;
+
 #endif /* GLOBAL_H */
\ No newline at end of file
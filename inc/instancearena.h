@@ -0,0 +1,165 @@
+#ifndef INSTANCE_ARENA_H
+#define INSTANCE_ARENA_H
+
+/* Standard Headers */
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+/* Project Headers */
+#include "global.h"
+
+/* Instance Arena Definitions */
+#define ARENA_CHUNK_SIZE                    (size_t)(2 * 1024 * 1024)   /* One x86-64 hugepage */
+#define ARENA_SLOT_ALIGN                    (size_t)(64)
+
+
+/* Maps one ARENA_CHUNK_SIZE chunk, hugepage-backed where the OS allows (nullptr on failure) */
+void* mapArenaChunk(void);
+
+
+/**
+ * Fixed-size slots for instances of T, carved out of hugepage-backed chunks.
+ *
+ * Freed slots go onto an intrusive free list and are handed out again by the
+ * next create(), so creating and destroying instances makes no heap calls.
+ * New chunks are only mapped when the free list runs dry; reserve() maps them
+ * up front. Chunks are never unmapped.
+ */
+template<typename T>
+class InstanceArena
+{
+    private:
+        struct FreeSlot
+        {
+            FreeSlot* next;
+        };
+
+        FreeSlot* freeList;
+        size_t slotCount;   /* Slots mapped so far */
+        size_t freeCount;
+        std::mutex lock;
+
+        InstanceArena() : freeList(nullptr), slotCount(0), freeCount(0) {}
+
+        /* Maps another chunk onto the free list (lock held) */
+        bool grow(void)
+        {
+            // T may still be incomplete where the arena type is named, so size it here
+            constexpr size_t slotSize = (sizeof(T) + ARENA_SLOT_ALIGN - 1) & ~(ARENA_SLOT_ALIGN - 1);
+            constexpr size_t slotsPerChunk = ARENA_CHUNK_SIZE / slotSize;
+            static_assert(slotsPerChunk > 0, "instances must fit in an arena chunk");
+            static_assert(alignof(T) <= ARENA_SLOT_ALIGN, "instances must fit the slot alignment");
+
+            U8* chunk = static_cast<U8*>(mapArenaChunk());
+            if(!chunk)
+            {
+                return false;
+            }
+
+            for(size_t i = slotsPerChunk; i-- > 0;)
+            {
+                FreeSlot* slot = reinterpret_cast<FreeSlot*>(chunk + i * slotSize);
+                slot->next = freeList;
+                freeList = slot;
+            }
+
+            slotCount += slotsPerChunk;
+            freeCount += slotsPerChunk;
+            return true;
+        }
+
+        void* allocate(void)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if(!freeList && !grow())
+            {
+                return nullptr;
+            }
+
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            freeCount--;
+            return slot;
+        }
+
+        void release(void* memory)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            FreeSlot* slot = static_cast<FreeSlot*>(memory);
+            slot->next = freeList;
+            freeList = slot;
+            freeCount++;
+        }
+
+    public:
+        struct Deleter
+        {
+            inline void operator()(T* instance) const { InstanceArena<T>::instance().destroy(instance); }
+        };
+
+        using Pointer = std::unique_ptr<T, Deleter>;
+
+        /* One arena per type, never destroyed so instances in static storage can outlive it */
+        static InstanceArena& instance(void)
+        {
+            static InstanceArena* arena = new InstanceArena();
+            return *arena;
+        }
+
+        /* Constructs an instance in a free slot (throws std::bad_alloc if no chunk can be mapped) */
+        template<typename... Args>
+        Pointer create(Args&&... args)
+        {
+            void* slot = allocate();
+            if(!slot)
+            {
+                throw std::bad_alloc();
+            }
+
+            try
+            {
+                return Pointer(new(slot) T(std::forward<Args>(args)...));
+            }
+            catch(...)
+            {
+                release(slot);
+                throw;
+            }
+        }
+
+        void destroy(T* instance)
+        {
+            if(instance)
+            {
+                instance->~T();
+                release(instance);
+            }
+        }
+
+        /* Maps chunks until at least count slots are free */
+        bool reserve(size_t count)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            while(freeCount < count)
+            {
+                if(!grow())
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /* Assessors */
+        inline size_t getSlotCount(void) { std::lock_guard<std::mutex> guard(lock); return slotCount; }
+        inline size_t getFreeCount(void) { std::lock_guard<std::mutex> guard(lock); return freeCount; }
+};
+
+
+#endif /* INSTANCE_ARENA_H */
\ No newline at end of file
@@ -1,11 +1,25 @@
-#ifndef MAIN_H
-#define MAIN_H
-
-/* Standard Headers */
-/* Project Headers */
-#include "bus.h"
-#include "global.h"
-#include "nesmemory.h"
-#include "rp2a03.h"
-
+#ifndef MAIN_H
+#define MAIN_H
+
+/* Standard Headers */
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+/* Project Headers */
+#include "bus.h"
+#include "cpuvalidator.h"
+#include "framepacer.h"
+#include "global.h"
+#include "nes.h"
+#include "nesmemory.h"
+#include "rp2a03.h"
+#include "rp2a03lockstep.h"
+
+/* Benchmark Definitions */
+#define BENCH_INSTRUCTIONS                  (U64)(200000)     /* Default run per lane */
+
 #endif /* MAIN_H */
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef NES_H
+#define NES_H
+
+/* Standard Headers */
+#include <cstddef>
+#include <memory>
+#include <string>
+/* Project Headers */
+#include "bus.h"
+#include "cartridge.h"
+#include "global.h"
+#include "instancearena.h"
+#include "rp2a03.h"
+#include "savestate.h"
+#include "statepublisher.h"
+
+
+/**
+ * A complete console: the bus (memory, PPU, controllers) and the CPU driving it.
+ */
+class NES
+{
+    private:
+        Bus bus;
+        RP2A03 cpu;
+
+        /* Optional shared memory snapshot after every frame */
+        std::unique_ptr<StatePublisher> publisher;
+
+        /* Save state size for the inserted cartridge (CHR RAM boards are larger) */
+        size_t stateBytes;
+
+        /* Run loop helpers */
+        void executeInstruction(void);
+        bool serviceInterrupts(void);
+        bool isInterruptReady(void);
+
+    public:
+        NES();
+        NES(const NES& other);
+        NES& operator=(const NES&) = delete;
+        ~NES();
+
+        /**
+         * Duplicates the console into a new live instance for tree search. The
+         * instance and its memory and PPU come from the instance arenas and the
+         * cartridge is shared, so cloning a console that doesn't render frames
+         * (PPU_RENDER_NEVER) on a CHR ROM board makes no heap calls. Shared memory
+         * publishing and pipelined rendering are not carried over.
+         */
+        InstanceArena<NES>::Pointer clone(void) const;
+
+        /* Maps arena chunks for at least count consoles up front */
+        static bool reserveInstances(size_t count);
+
+        /* Cartridge */
+        bool loadROM(const U8* data, size_t size);
+        bool loadROM(const std::string& path);
+        void insertCartridge(std::shared_ptr<const Cartridge> cart);
+
+        /* Execution */
+        void reset(void);
+        void stepInstruction(void);
+        void stepFrame(void);
+
+        /* Shared memory publishing (an empty name stops publishing) */
+        bool publishState(const std::string& segmentName);
+
+        /* Save states */
+        inline size_t stateSize(void) { return stateBytes; }
+        size_t saveState(U8* buffer, size_t size);
+        bool loadState(const U8* buffer, size_t size);
+
+        /* Assessors */
+        inline RP2A03* getCPU(void) { return &cpu; }
+        inline Bus* getBus(void) { return &bus; }
+        inline RP2C02* getPPU(void) { return bus.getPPU(); }
+        inline U8* getRAM(void) { return bus.getMemory()->getRAM(); }
+        inline const U8* getFrameBuffer(void) { return bus.getPPU()->getFrameBuffer(); }
+
+        /* Modifiers */
+        inline void setInput(U8 port, U8 buttons) { bus.setControllerState(port, buttons); }
+};
+
+
+#endif /* NES_H */
\ No newline at end of file
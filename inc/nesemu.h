@@ -0,0 +1,108 @@
+#ifndef NESEMU_H
+#define NESEMU_H
+
+/*
+ * Embeddable C interface (libnesemu).
+ *
+ * Every call takes the handle returned by nes_create(). The frame buffer and RAM
+ * pointers point straight into emulator memory: they stay valid until the handle
+ * is destroyed (the frame buffer also until the render interval is changed), and
+ * reading them never copies.
+ */
+
+/* Standard Headers */
+#include <stddef.h>
+#include <stdint.h>
+
+/* NESEMU_BUILD is defined while building the library; consumers import */
+#if defined(_WIN32) && defined(NESEMU_BUILD)
+#define NESEMU_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define NESEMU_API __declspec(dllimport)
+#else
+#define NESEMU_API __attribute__((visibility("default")))
+#endif
+
+/* Output Definitions */
+#define NESEMU_SCREEN_WIDTH                 256
+#define NESEMU_SCREEN_HEIGHT                240
+#define NESEMU_RAM_SIZE                     2048
+
+/* Controller Buttons */
+#define NESEMU_BUTTON_A                     0x01
+#define NESEMU_BUTTON_B                     0x02
+#define NESEMU_BUTTON_SELECT                0x04
+#define NESEMU_BUTTON_START                 0x08
+#define NESEMU_BUTTON_UP                    0x10
+#define NESEMU_BUTTON_DOWN                  0x20
+#define NESEMU_BUTTON_LEFT                  0x40
+#define NESEMU_BUTTON_RIGHT                 0x80
+
+/* Pixel Formats (byte order in memory) */
+#define NESEMU_FORMAT_RGBA8888              0
+#define NESEMU_FORMAT_BGRA8888              1
+#define NESEMU_FORMAT_RGB565                2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opaque console handle */
+typedef struct nes_t nes_t;
+
+/* Lifetime */
+NESEMU_API nes_t* nes_create(void);
+NESEMU_API void nes_destroy(nes_t* nes);
+
+/* Tree search: duplicate a running console (cartridge shared, memory from
+   preallocated hugepage arenas; nes_reserve maps room for count consoles) */
+NESEMU_API nes_t* nes_clone(nes_t* nes);
+NESEMU_API int nes_reserve(size_t count);
+
+/* Cartridge (0 on success, -1 on failure) */
+NESEMU_API int nes_load_rom(nes_t* nes, const uint8_t* data, size_t size);
+NESEMU_API int nes_load_rom_file(nes_t* nes, const char* path);
+
+/* Execution */
+NESEMU_API void nes_reset(nes_t* nes);
+NESEMU_API void nes_step_frame(nes_t* nes);
+NESEMU_API void nes_step_frames(nes_t* nes, uint32_t count);
+NESEMU_API uint64_t nes_frame_count(nes_t* nes);
+
+/* Input: port 0 or 1, buttons as NESEMU_BUTTON_* bits */
+NESEMU_API void nes_set_input(nes_t* nes, int port, uint8_t buttons);
+
+/* Save states (0 on success, -1 on failure) */
+NESEMU_API size_t nes_state_size(nes_t* nes);
+NESEMU_API int nes_save_state(nes_t* nes, void* buffer, size_t size);
+NESEMU_API int nes_load_state(nes_t* nes, const void* buffer, size_t size);
+
+/* Incremental state tracking: 64-bit hash of the full state, rehashing only pages
+   written since the last call; deltas hold the pages written since the previous
+   delta (the first one holds everything). nes_save_delta returns the delta size,
+   larger than size if it didn't fit. Call nes_mark_dirty after writing through nes_ram */
+NESEMU_API uint64_t nes_state_hash(nes_t* nes);
+NESEMU_API size_t nes_save_delta(nes_t* nes, void* buffer, size_t size);
+NESEMU_API int nes_load_delta(nes_t* nes, const void* buffer, size_t size);
+NESEMU_API void nes_mark_dirty(nes_t* nes);
+
+/* Zero-copy views */
+NESEMU_API const uint8_t* nes_framebuffer(nes_t* nes);  /* 256x240 palette indices, NULL while not rendering */
+NESEMU_API uint8_t* nes_ram(nes_t* nes);                /* 2 KB of internal RAM */
+
+/* Convert the current frame (palette and color emphasis applied) into 256x240
+   pixels of a NESEMU_FORMAT_*, rows pitch bytes apart (0 on success, -1 while not rendering) */
+NESEMU_API int nes_convert_frame(nes_t* nes, void* pixels, size_t pitch, int format);
+
+/* Publish registers, RAM and frame into POSIX shared memory after every frame
+   (layout: SharedState in statepublisher.h); NULL stops publishing */
+NESEMU_API int nes_publish_shm(nes_t* nes, const char* name);
+
+/* Frame skip: render every Nth frame, 0 for never (0 on success, -1 above 65535) */
+NESEMU_API int nes_set_render_interval(nes_t* nes, uint32_t interval);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NESEMU_H */
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef NETPLAY_H
+#define NETPLAY_H
+
+/* Standard Headers */
+#include <array>
+#include <vector>
+/* Project Headers */
+#include "global.h"
+#include "nes.h"
+#include "transport.h"
+
+/* Netplay Definitions */
+#define NETPLAY_PACKET_MAGIC                (U32)(0x504E454E)   /* "NENP" */
+#define NETPLAY_HISTORY                     (U32)(128)          /* Frames of input kept (power of two) */
+#define NETPLAY_MAX_ROLLBACK                (U32)(60)           /* Upper bound for the rollback window */
+#define NETPLAY_INPUT_WINDOW                (U32)(32)           /* Unacknowledged frames resent per packet */
+#define NETPLAY_FRAME_BUDGET_US             (U32)(16639)        /* One NTSC frame (60.0988 Hz, ~16.6 ms) */
+#define NETPLAY_NO_ROLLBACK                 (U32)(0xFFFFFFFF)
+
+
+/* Counters since the session started */
+struct RollbackStats
+{
+    U64 frames;             /* Frames advanced */
+    U64 stalls;             /* advanceFrame() calls that waited for the remote */
+    U64 rollbacks;          /* Mispredictions corrected */
+    U64 resimulatedFrames;  /* Frames re-run by rollbacks */
+    U64 catchUps;           /* advanceFrame() calls spent re-simulating (over the catch-up limit) */
+    U32 deepestRollback;    /* Most frames re-run by a single rollback */
+    U64 lastRollbackUs;     /* Restore and re-simulation time of the latest rollback */
+};
+
+
+/**
+ * Two-player rollback netplay on top of a Transport.
+ *
+ * Every frame the local input is sent to the peer (with the frames it hasn't
+ * acknowledged yet) and the console runs ahead with a predicted remote input:
+ * the last one received. Before each frame a snapshot is kept in memory. When
+ * a remote input arrives that differs from the prediction, the console is
+ * restored to that frame's snapshot and the frames since are re-simulated with
+ * pixel generation off. The console runs at most maxRollback frames ahead of
+ * the last confirmed remote input and stalls beyond that.
+ *
+ * At most catchUpLimit frames are re-simulated per advanceFrame() call; a
+ * deeper rollback is spread over several calls, which don't advance the frame.
+ * measureRollbackCapacity() sets the limit from what the host can run within
+ * one frame budget. Until then re-simulation is not limited.
+ *
+ * Both peers must start from the same state (same cartridge, freshly reset or
+ * loaded from the same save state).
+ */
+class RollbackSession
+{
+    private:
+        NES& console;
+        Transport& transport;
+        U8 localPort;       /* Controller port of the local player (the remote player has the other) */
+        U32 maxRollback;
+
+        U32 frame;              /* Next frame to run */
+        U32 remoteConfirmed;    /* Remote inputs received for frames [0, remoteConfirmed) */
+        U32 peerAck;            /* The peer has our inputs for frames [0, peerAck) */
+        U32 rollbackFrom;       /* Earliest mispredicted frame (NETPLAY_NO_ROLLBACK: none) */
+        U32 resimulateTo;       /* Re-simulation runs up to this frame (frame: caught up) */
+        U32 catchUpLimit;       /* Frames re-simulated per advanceFrame() call */
+
+        std::vector<U8> localInputs;    /* Indexed by frame % NETPLAY_HISTORY */
+        std::vector<U8> remoteInputs;
+        std::vector<U8> usedInputs;     /* Remote input each frame was simulated with */
+
+        std::vector<std::vector<U8>> snapshots; /* State before each frame, indexed by frame % (maxRollback + 1) */
+
+        RollbackStats stats;
+
+        void sendInputs(void);
+        void receiveInputs(void);
+        void rollback(void);
+        void resimulate(void);
+        void runFrame(U8 remoteButtons);
+        U8 predictRemote(void);
+
+    public:
+        RollbackSession(NES& nes, Transport& link, U8 port, U32 rollbackFrames = 8);
+        ~RollbackSession();
+
+        /* Runs one frame with the local buttons; false if stalled waiting for the remote */
+        bool advanceFrame(U8 localButtons);
+
+        /* Restores and re-simulates frames for one frame budget, then returns to the
+           current state; the result (less the live frame) becomes the catch-up limit */
+        U32 measureRollbackCapacity(void);
+
+        /* Assessors */
+        inline U32 getFrame(void) { return frame; }
+        inline U32 getRemoteConfirmed(void) { return remoteConfirmed; }
+        inline U32 getCatchUpLimit(void) { return catchUpLimit; }
+        inline const RollbackStats& getStats(void) { return stats; }
+
+        /* Modifiers */
+        inline void setCatchUpLimit(U32 frames) { catchUpLimit = frames ? frames : 1; }
+};
+
+
+#endif /* NETPLAY_H */
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+/* Standard Headers */
+#include <array>
+#include <cstddef>
+/* Project Headers */
+#include "global.h"
+#include "rp2c02.h"
+
+/* Palette Definitions */
+#define PALETTE_COLORS                      (U16)(64)
+#define PALETTE_EMPHASIS_COMBINATIONS       (U16)(8)
+#define PALETTE_ENTRIES                     (U16)(PALETTE_COLORS * PALETTE_EMPHASIS_COMBINATIONS)
+#define PALETTE_EMPHASIS_ATTENUATION        (double)(0.816328)  /* Emphasizing a channel darkens the other two */
+
+/* AVX2 gathers, chosen at run time (GCC/Clang target attributes on x86) */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PALETTE_AVX2                        1
+#else
+#define PALETTE_AVX2                        0
+#endif
+
+
+/* Output pixel formats (byte order in memory) */
+enum class PixelFormat
+{
+    RGBA8888,   /* R, G, B, A */
+    BGRA8888,   /* B, G, R, A */
+    RGB565      /* 16-bit native endian, red in the high bits */
+};
+
+
+/**
+ * Output stage: converts the PPU frame buffer (6-bit colors already resolved
+ * through palette RAM at PPU_IMAGE_PALETTE_BASE_ADDR, plus the per-scanline
+ * $2001 emphasis bits) into host pixels.
+ *
+ * Each format has a precomputed 512-entry table (64 colors x 8 emphasis
+ * combinations), so conversion is one lookup per pixel. On x86 CPUs with AVX2
+ * the lookups are done 8 pixels at a time with gathers; the path is picked at
+ * run time, so it doesn't depend on NATIVE=1.
+ *
+ * The 32-bit entries are stored so that they land in memory in the format's
+ * byte order on little-endian hosts, the only ones the tables are built for.
+ */
+class PaletteConverter
+{
+    private:
+        std::array<U32, PALETTE_ENTRIES> rgba;
+        std::array<U32, PALETTE_ENTRIES> bgra;
+        std::array<U32, PALETTE_ENTRIES> rgb565;    /* Widened to 32 bits for gathers */
+        bool avx2;                                  /* AVX2 path in use */
+        bool avx2Supported;                         /* CPU supports the AVX2 path */
+
+    public:
+        PaletteConverter();
+
+        /* Shared converter, with the fastest path the CPU supports */
+        static const PaletteConverter& instance(void);
+
+        void convertFrame(const U8* frameBuffer, void* destination, size_t pitch, PixelFormat format) const;
+
+        /* Assessors */
+        inline bool usesSIMD(void) const { return avx2; }
+
+        /* Modifiers */
+        /* Falls back to the scalar path, or back to AVX2 if the CPU supports it */
+        inline void setSIMD(bool enable) { avx2 = enable && avx2Supported; }
+};
+
+
+#endif /* PALETTE_H */
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef PPU_PIPELINE_H
+#define PPU_PIPELINE_H
+
+/* Standard Headers */
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+/* Project Headers */
+#include "global.h"
+#include "rp2c02.h"
+
+
+/* Recorded PPU side effects */
+enum class PPUCommandType : U8
+{
+    registerWrite,      /* CPU write to 0x2000 - 0x2007 */
+    registerRead,       /* CPU read with side effects ($2002, $2007) */
+    renderInterval,     /* Frame skip interval change */
+    mirroring,          /* Name table mirroring change */
+    reset,              /* PPU reset */
+    oamDMA,             /* OAM DMA (addr: index of the 256-byte block in the DMA log) */
+    restore             /* Replica replaced by a saved PPU (addr: index in the restore log) */
+};
+
+
+/* Timestamped PPU command */
+struct PPUCommand
+{
+    U64 timestamp;      /* PPU dot count at which the access happened */
+    PPUCommandType type;
+    U16 addr;           /* Register address, or the new setting */
+    U8 data;            /* Written value */
+};
+
+
+/* PPU state a restore command puts into the replica */
+struct PPURestore
+{
+    std::shared_ptr<const Cartridge> cartridge;
+    std::vector<U8> state;      /* RP2C02::saveState() */
+};
+
+
+/**
+ * Renders frames on a worker thread from a per-frame log of PPU commands.
+ *
+ * The worker owns a replica of the PPU that is kept in sync by replaying every
+ * recorded command at the dot it happened on, so the replica produces the same
+ * pixels the synchronous PPU would have. While the worker renders frame N the
+ * CPU thread emulates frame N+1.
+ *
+ * The presented frame is the one completed before the latest submitFrame(), so
+ * pipelined rendering adds one frame (~16.6 ms on NTSC) of input-to-display
+ * latency over synchronous rendering in exchange for the overlap.
+ *
+ * State restores and cartridge changes on the CPU thread don't restart the
+ * worker: recordRestore() puts a copy of the PPU into the log and the replica
+ * takes it over when the replay reaches it.
+ */
+class PPURenderPipeline
+{
+    private:
+        /* Render-only PPU state, touched by the worker thread only while busy */
+        RP2C02 replica;
+
+        /* Commands recorded by the CPU thread for the frame in progress */
+        std::vector<PPUCommand> recording;
+        std::vector<U8> recordingDMA;
+        std::vector<PPURestore> recordingRestores;
+
+        /* Frame handed to the worker */
+        std::vector<PPUCommand> pending;
+        std::vector<U8> pendingDMA;
+        std::vector<PPURestore> pendingRestores;
+        U64 pendingEndDot;
+        bool pendingRender; /* false: replay the frame without generating pixels */
+
+        /* Last completed frame, owned by the CPU thread */
+        std::array<U8, PPU_FRAME_BUFFER_SIZE> presented;
+        U64 presentedFrames;
+        U64 presentedFrame;     /* Frame number of the presented frame (RP2C02::getFrameBufferFrame) */
+        bool frameReady;
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool busy;
+        bool stopping;
+        std::thread worker;
+
+        void workerLoop(void);
+        void replay(void);
+        void present(void);
+        void restore(const PPURestore& snapshot);
+
+    public:
+        explicit PPURenderPipeline(const RP2C02& source);
+        ~PPURenderPipeline();
+
+        /* CPU thread interface */
+        void record(PPUCommandType type, U64 timestamp, U16 addr, U8 data);
+        void recordOAMDMA(U64 timestamp, const U8* data);
+        void recordRestore(RP2C02& source);
+        void submitFrame(U64 endDot, bool render = true);
+        void finish(void);
+
+        /* Assessors */
+        inline const U8* getFrameBuffer(void) { return presented.data(); }
+        inline U64 getPresentedFrames(void) { return presentedFrames; }
+        inline U64 getPresentedFrame(void) { return presentedFrame; }
+};
+
+
+#endif /* PPU_PIPELINE_H */
\ No newline at end of file
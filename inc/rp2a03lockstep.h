@@ -0,0 +1,137 @@
+#ifndef RP2A03_LOCKSTEP_H
+#define RP2A03_LOCKSTEP_H
+
+/* Standard Headers */
+#include <array>
+#include <memory>
+#include <vector>
+/* Project Headers */
+#include "bus.h"
+#include "cartridge.h"
+#include "global.h"
+#include "rp2a03.h"
+
+/* Lockstep Engine Definitions */
+#define LOCKSTEP_LANES                      (U32)(32)
+#define LOCKSTEP_RAM_SIZE                   (U16)(0x0800)
+
+/* AVX2/AVX-512 kernels, chosen at run time (GCC/Clang target attributes on x86) */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LOCKSTEP_SIMD                       1
+#else
+#define LOCKSTEP_SIMD                       0
+#endif
+
+
+/* One bit per lane */
+using LaneMask = U32;
+
+
+/* Instruction sets of the lane kernels, best first */
+enum class LockstepISA : U8
+{
+    avx512,     /* AVX-512BW/VL mask registers */
+    avx2,       /* AVX2 blends */
+    portable    /* Branch-free C++ */
+};
+
+
+/**
+ * Runs LOCKSTEP_LANES RP2A03 instances side by side in structure-of-arrays
+ * layout, for rollouts where every console runs the same cartridge.
+ *
+ * Each step fetches one opcode per lane, groups the lanes by opcode, and runs
+ * every group through the instruction's lane kernel under a lane mask. When all
+ * lanes share an opcode this is a single masked vector operation; lanes that
+ * diverge fall back to per-lane execution. Instruction semantics follow the
+ * RP2A03 instruction vector (instrArray) exactly. The kernels use AVX-512 or
+ * AVX2 when the CPU has them, picked at run time like the palette converter.
+ *
+ * Internal RAM is striped by lane (byte addr of lane l lives at
+ * addr * LOCKSTEP_LANES + l). PRG ROM is read from the shared cartridge; other
+ * addresses go to the lane's Bus, if one is attached.
+ *
+ * Accesses below $2000 (internal RAM and its mirrors) are served from the
+ * striped RAM only and never reach the attached Bus: its RAM, dirty page
+ * tracking and state publishing don't follow the lane. Use readRAM() and
+ * writeRAM() (or loadLane()) to move RAM between a lane and a console.
+ */
+class RP2A03Lockstep
+{
+    private:
+        /* Registers (one entry per lane) */
+        alignas(64) std::array<U16, LOCKSTEP_LANES> PC;
+        alignas(64) std::array<U8, LOCKSTEP_LANES> SP;
+        alignas(64) std::array<U8, LOCKSTEP_LANES> A;
+        alignas(64) std::array<U8, LOCKSTEP_LANES> X;
+        alignas(64) std::array<U8, LOCKSTEP_LANES> Y;
+        alignas(64) std::array<U8, LOCKSTEP_LANES> status;
+        std::array<U64, LOCKSTEP_LANES> cycles;
+
+        /* Lanes that take part in step() */
+        LaneMask activeLanes;
+
+        /* Kernel instruction set: in use, and the best the CPU supports */
+        LockstepISA isa;
+        LockstepISA supportedISA;
+
+        /* Internal RAM, striped by lane */
+        std::vector<U8> ram;
+
+        /* Shared PRG ROM and per-lane devices (not owned) */
+        std::shared_ptr<const Cartridge> cartridge;
+        std::array<Bus*, LOCKSTEP_LANES> buses;
+
+        /* Per-step scratch */
+        alignas(64) std::array<U8, LOCKSTEP_LANES> opcode;
+        alignas(64) std::array<U16, LOCKSTEP_LANES> operand;
+
+        /* Lane kernel: executes one instruction for every lane in the mask */
+        using Kernel = void (RP2A03Lockstep::*)(LaneMask lanes);
+        static std::array<Kernel, 256> buildKernelArray(void);
+
+        /* Lane memory access */
+        U8 readLane(U32 lane, U16 addr);
+        U16 readVector(U32 lane, U16 vector);
+
+        /* Pseudo-pipeline member functions */
+        void fetch(void);
+        void applyAddressingMode(const RP2A03::Instr_t& instr, LaneMask lanes);
+        void executeGroup(U8 opCode, LaneMask lanes);
+
+        /* Lane kernels */
+        void LDA(LaneMask lanes);
+        void NOP(LaneMask lanes);
+
+    public:
+        RP2A03Lockstep();
+        ~RP2A03Lockstep();
+
+        /* Public Member functions */
+        void step(void);
+        void reset(void);
+
+        /* Assessors */
+        inline U16 getPC(U32 lane) { return PC[lane]; }
+        inline U8 getSP(U32 lane) { return SP[lane]; }
+        inline U8 getA(U32 lane) { return A[lane]; }
+        inline U8 getX(U32 lane) { return X[lane]; }
+        inline U8 getY(U32 lane) { return Y[lane]; }
+        inline U8 getStatus(U32 lane) { return status[lane]; }
+        inline U64 getCycles(U32 lane) { return cycles[lane]; }
+        inline LaneMask getActiveLanes(void) { return activeLanes; }
+        inline LockstepISA getISA(void) { return isa; }
+        inline U8 readRAM(U32 lane, U16 addr) { return ram[(addr & 0x07FF) * LOCKSTEP_LANES + lane]; }
+
+        /* Modifiers */
+        void setRegisters(U32 lane, U16 pc, U8 sp, U8 a, U8 x, U8 y, U8 flags);
+        void loadLane(U32 lane, RP2A03& cpu, const U8* internalRam);
+        inline void writeRAM(U32 lane, U16 addr, U8 data) { ram[(addr & 0x07FF) * LOCKSTEP_LANES + lane] = data; }
+        inline void setActiveLanes(LaneMask lanes) { activeLanes = lanes; }
+        void setISA(LockstepISA requested);
+        inline void attachBus(U32 lane, Bus* bus) { buses[lane] = bus; }
+        inline void insertCartridge(std::shared_ptr<const Cartridge> cart) { cartridge = std::move(cart); }
+};
+
+
+#endif /* RP2A03_LOCKSTEP_H */
\ No newline at end of file
@@ -1,69 +1,254 @@
-#ifndef RP2C02_H
-#define RP2C02_H
-
-#include <array>
-#include "global.h"
-
-/* PPU Memory Map Definitions */
-#define PPU_MEM_BASE_ADDR                   (U16)(0X0000)
-#define PPU_PTRN_TABLE0_BASE_ADDR           (U16)(0x0000)
-#define PPU_PTRN_TABLE1_BASE_ADDR           (U16)(0x1000)
-#define PPU_NAME_TABLE0_BASE_ADDR           (U16)(0x2000)
-#define PPU_ATTR_TABLE0_BASE_ADDR           (U16)(0x23C0)
-#define PPU_NAME_TABLE1_BASE_ADDR           (U16)(0x2400)
-#define PPU_ATTR_TABLE1_BASE_ADDR           (U16)(0x27C0)
-#define PPU_NAME_TABLE2_BASE_ADDR           (U16)(0x2800)
-#define PPU_ATTR_TABLE2_BASE_ADDR           (U16)(0x2BC0)
-#define PPU_NAME_TABLE3_BASE_ADDR           (U16)(0x2C00)
-#define PPU_ATTR_TABLE3_BASE_ADDR           (U16)(0x2FC0)
-#define PPU_MIRROR1_BASE_AADR               (U16)(0x3000)
-#define PPU_IMAGE_PALETTE_BASE_ADDR         (U16)(0x3F00)
-#define PPU_SPRITE_PALETTE_BASE_ADDR        (U16)(0x3F10)
-#define PPU_MIRROR2_BASE_ADDR               (U16)(0x3F20)
-#define PPU_MIRROR3_BASE_ADDR               (U16)(0x4000)
-
-
-class RP2C02
-{
-    private:
-        struct PatternTableMem_Typedef
-        {
-            std::array<U8, 4096> patternTable0;     /* 0x0000 - 0x0FFF */
-            std::array<U8, 4096> patternTable1;     /* 0x1000 - 0x1FFF */
-        }*patternTables;
-
-
-        struct NameTableMem_Typedef
-        {
-            std::array<U8, 960> nameTable0;         /* 0x2000 - 0x23BF */
-            std::array<U8, 64> attrTable0;          /* 0x23CO - 0x23FF */
-            std::array<U8, 960> nameTable1;         /* 0x2400 - 0x27BF */
-            std::array<U8, 64> attrTable1;          /* 0x27C0 - 0x27FF */
-            std::array<U8, 960> nameTable2;         /* 0x2800 - 0x2BBF */
-            std::array<U8, 64> attrTable2;          /* 0x2BC0 - 0x2BFF */
-            std::array<U8, 960> nameTable3;         /* 0x2C00 - 0x2FBF */
-            std::array<U8, 64> attrTable3;          /* 0x2FC0 - 0x2FFF */
-            std::array<U8, 3840> mirrors;           /* 0x3000 - 0x3EFF */
-        }*nameTables;
-
-
-        struct PaletteMem_Typedef
-        {
-            std::array<U8, 16> imagePalette;        /* 0x3F00 - 0x3F0F */
-            std::array<U8, 16> spritePalette;       /* 0x3F10 - 0x3F1F */
-            std::array<U8, 224> mirrors;            /* 0x3f20 - 0x4000 */
-        }*paletteTables;
-
-
-        struct MirrorMem_Typedef
-        {
-            std::array<U8, 24576> mirrors;          /* 0x4000 - 0x9FFF */
-        }*mirrors;
-
-    public:
-        RP2C02();
-        ~RP2C02();
-};
-
-
+#ifndef RP2C02_H
+#define RP2C02_H
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+#include "cartridge.h"
+#include "dirtypages.h"
+#include "global.h"
+#include "savestate.h"
+
+/* Forward Declarations */
+class PPURenderPipeline;
+
+/* PPU Memory Map Definitions */
+#define PPU_MEM_BASE_ADDR                   (U16)(0X0000)
+#define PPU_PTRN_TABLE0_BASE_ADDR           (U16)(0x0000)
+#define PPU_PTRN_TABLE1_BASE_ADDR           (U16)(0x1000)
+#define PPU_NAME_TABLE0_BASE_ADDR           (U16)(0x2000)
+#define PPU_ATTR_TABLE0_BASE_ADDR           (U16)(0x23C0)
+#define PPU_NAME_TABLE1_BASE_ADDR           (U16)(0x2400)
+#define PPU_ATTR_TABLE1_BASE_ADDR           (U16)(0x27C0)
+#define PPU_NAME_TABLE2_BASE_ADDR           (U16)(0x2800)
+#define PPU_ATTR_TABLE2_BASE_ADDR           (U16)(0x2BC0)
+#define PPU_NAME_TABLE3_BASE_ADDR           (U16)(0x2C00)
+#define PPU_ATTR_TABLE3_BASE_ADDR           (U16)(0x2FC0)
+#define PPU_MIRROR1_BASE_AADR               (U16)(0x3000)
+#define PPU_IMAGE_PALETTE_BASE_ADDR         (U16)(0x3F00)
+#define PPU_SPRITE_PALETTE_BASE_ADDR        (U16)(0x3F10)
+#define PPU_MIRROR2_BASE_ADDR               (U16)(0x3F20)
+#define PPU_MIRROR3_BASE_ADDR               (U16)(0x4000)
+
+/* PPU Register Definitions (offsets from 0x2000 in CPU memory) */
+#define PPU_REG_CTRL                        (U8)(0x00)
+#define PPU_REG_MASK                        (U8)(0x01)
+#define PPU_REG_STATUS                      (U8)(0x02)
+#define PPU_REG_OAM_ADDR                    (U8)(0x03)
+#define PPU_REG_OAM_DATA                    (U8)(0x04)
+#define PPU_REG_SCROLL                      (U8)(0x05)
+#define PPU_REG_ADDR                        (U8)(0x06)
+#define PPU_REG_DATA                        (U8)(0x07)
+
+/* PPU Frame Timing Definitions (NTSC) */
+#define PPU_DOTS_PER_SCANLINE               (U16)(341)
+#define PPU_SCANLINES_PER_FRAME             (U16)(262)
+#define PPU_VISIBLE_SCANLINES               (U16)(240)
+#define PPU_VBLANK_SCANLINE                 (U16)(241)
+#define PPU_PRERENDER_SCANLINE              (U16)(261)
+
+/* PPU Output Definitions */
+#define PPU_SCREEN_WIDTH                    (U16)(256)
+#define PPU_SCREEN_HEIGHT                   (U16)(240)
+#define PPU_RENDER_NEVER                    (U16)(0)
+#define PPU_EMPHASIS_OFFSET                 (U32)(PPU_SCREEN_WIDTH * PPU_SCREEN_HEIGHT)
+#define PPU_FRAME_BUFFER_SIZE               (U32)(PPU_EMPHASIS_OFFSET + PPU_SCREEN_HEIGHT)
+
+
+namespace PPUFlags
+{
+    /* Constant Expressions: PPUCTRL ($2000) */
+    constexpr U8 CTRL_NAMETABLE_SELECT      = 0x03; /* BIT0-1: Base nametable address */
+    constexpr U8 CTRL_INCREMENT_32          = 0x04; /* BIT2: VRAM address increment (0: +1, 1: +32) */
+    constexpr U8 CTRL_SPRITE_TABLE          = 0x08; /* BIT3: Sprite pattern table (8x8 sprites only) */
+    constexpr U8 CTRL_BG_TABLE              = 0x10; /* BIT4: Background pattern table */
+    constexpr U8 CTRL_SPRITE_SIZE           = 0x20; /* BIT5: Sprite size (0: 8x8, 1: 8x16) */
+    constexpr U8 CTRL_NMI_ENABLE            = 0x80; /* BIT7: Generate NMI at the start of vblank */
+    /* Constant Expressions: PPUMASK ($2001) */
+    constexpr U8 MASK_GREYSCALE             = 0x01; /* BIT0: Greyscale */
+    constexpr U8 MASK_BG_LEFT               = 0x02; /* BIT1: Show background in leftmost 8 pixels */
+    constexpr U8 MASK_SPRITE_LEFT           = 0x04; /* BIT2: Show sprites in leftmost 8 pixels */
+    constexpr U8 MASK_SHOW_BG               = 0x08; /* BIT3: Show background */
+    constexpr U8 MASK_SHOW_SPRITES          = 0x10; /* BIT4: Show sprites */
+    constexpr U8 MASK_EMPHASIS              = 0xE0; /* BIT5-7: Emphasize red, green, blue */
+    /* Constant Expressions: PPUSTATUS ($2002) */
+    constexpr U8 STATUS_SPRITE_OVERFLOW     = 0x20; /* BIT5: More than 8 sprites on a scanline */
+    constexpr U8 STATUS_SPRITE0_HIT         = 0x40; /* BIT6: Sprite 0 hit */
+    constexpr U8 STATUS_VBLANK              = 0x80; /* BIT7: Vertical blank has started */
+    /* Constant Expressions: OAM sprite attributes */
+    constexpr U8 SPRITE_PALETTE             = 0x03; /* BIT0-1: Sprite palette */
+    constexpr U8 SPRITE_BEHIND_BG           = 0x20; /* BIT5: Priority (0: in front, 1: behind background) */
+    constexpr U8 SPRITE_FLIP_HORIZONTAL     = 0x40; /* BIT6: Flip sprite horizontally */
+    constexpr U8 SPRITE_FLIP_VERTICAL       = 0x80; /* BIT7: Flip sprite vertically */
+}
+
+
+class RP2C02
+{
+    private:
+        /* Pattern tables (0x0000 - 0x1FFF): CHR ROM shared with every instance running
+           the cartridge, or 8 KB of per-instance CHR RAM when the board has no CHR ROM */
+        std::shared_ptr<const Cartridge> cartridge;
+        std::vector<U8> chrRam;
+
+
+        struct NameTableMem_Typedef
+        {
+            std::array<U8, 960> nameTable0;         /* 0x2000 - 0x23BF */
+            std::array<U8, 64> attrTable0;          /* 0x23CO - 0x23FF */
+            std::array<U8, 960> nameTable1;         /* 0x2400 - 0x27BF */
+            std::array<U8, 64> attrTable1;          /* 0x27C0 - 0x27FF */
+            std::array<U8, 960> nameTable2;         /* 0x2800 - 0x2BBF */
+            std::array<U8, 64> attrTable2;          /* 0x2BC0 - 0x2BFF */
+            std::array<U8, 960> nameTable3;         /* 0x2C00 - 0x2FBF */
+            std::array<U8, 64> attrTable3;          /* 0x2FC0 - 0x2FFF */
+        }nameTables;                                /* 0x3000 - 0x3EFF mirror 0x2000 - 0x2EFF */
+
+
+        struct PaletteMem_Typedef
+        {
+            std::array<U8, 16> imagePalette;        /* 0x3F00 - 0x3F0F */
+            std::array<U8, 16> spritePalette;       /* 0x3F10 - 0x3F1F */
+        }paletteTables;                             /* 0x3F20 - 0x3FFF mirror 0x3F00 - 0x3F1F */
+
+        /* 0x4000 - 0xFFFF mirror 0x0000 - 0x3FFF */
+
+        /* Object Attribute Memory: 64 sprites, 4 bytes each */
+        std::array<U8, 256> oam;
+
+        /* Registers */
+        U8 ctrl;            /* PPUCTRL ($2000) */
+        U8 mask;            /* PPUMASK ($2001) */
+        U8 status;          /* PPUSTATUS ($2002) */
+        U8 oamAddr;         /* OAMADDR ($2003) */
+        U8 dataBuffer;      /* PPUDATA ($2007) read buffer */
+
+        /* Internal scroll registers */
+        U16 v;              /* Current VRAM address (15 bits) */
+        U16 t;              /* Temporary VRAM address (15 bits) */
+        U8 fineX;           /* Fine X scroll (3 bits) */
+        bool writeToggle;   /* First/second write toggle for $2005/$2006 */
+
+        /* Frame timing */
+        U16 scanline;       /* 0 - 261 */
+        U16 dot;            /* 0 - 340 */
+        U64 frameCount;     /* Number of frames that have reached vblank */
+        U64 dotCount;       /* Number of dots since power-up */
+        bool oddFrame;
+
+        /* Frame skip control */
+        U16 renderInterval; /* Generate pixels every Nth frame (PPU_RENDER_NEVER: never) */
+        bool renderingFrame;/* Pixels are generated for the current frame */
+        bool outputSuppressed;  /* No pixels at all, frame buffer kept (see setOutputSuppressed) */
+        U64 renderedFrame;      /* frameCount of the frame in frameBuffer (0: none since reset) */
+
+        /* Per-scanline sprite state */
+        std::array<U8, 8> lineSprites;  /* OAM indices of the sprites on this scanline */
+        U8 lineSpriteCount;
+        bool lineHasSprite0;
+        bool lineOverflow;  /* More than 8 sprites on the next scanline */
+        U16 sprite0HitDot;  /* Dot at which sprite 0 hit is raised (0: no hit on this scanline) */
+
+        /* Nametable arrangement */
+        Mirroring mirroring;
+
+        /* Palette index output (6-bit color per pixel), followed by the color emphasis
+           bits of each scanline (PPU_EMPHASIS_OFFSET). Only allocated while frames are rendered */
+        std::vector<U8> frameBuffer;
+
+        /* Render worker that generates pixels from the recorded register log (not owned) */
+        PPURenderPipeline* pipeline;
+
+        /* Written pages of name tables, OAM and CHR RAM are marked here (not owned) */
+        DirtyPages* dirtyPages;
+
+        /* PPU memory access */
+        U8 ppuRead(U16 addr);
+        void ppuWrite(U16 addr, U8 data);
+        U8* nameTableEntry(U16 addr);
+        U8* paletteEntry(U16 addr);
+
+        /* Rendering pipeline */
+        void beginScanline(void);
+        void evaluateSprites(void);
+        U16 findSprite0Hit(void);
+        void renderScanline(void);
+        void fetchBackgroundTile(U16 column, U8* lowPlane, U8* highPlane, U8* palette);
+        U8 fetchSpriteRow(U8 oamIndex, U8* lowPlane, U8* highPlane);
+        void incrementY(void);
+        void copyHorizontal(void);
+        void copyVertical(void);
+
+    public:
+        RP2C02();
+        ~RP2C02();
+
+        /* Public Member functions */
+        void PPU_Cycle(void);
+        void reset(void);
+
+        /* Save states */
+        void saveState(StateWriter& state);
+        void loadState(StateReader& state);
+        void saveRegisters(StateWriter& state);
+        void loadRegisters(StateReader& state);
+
+        /* CPU facing registers (0x2000 - 0x2007) */
+        U8 readRegister(U16 addr);
+        void writeRegister(U16 addr, U8 data);
+
+        /* OAM DMA: 256 OAMDATA writes at once */
+        void oamDMA(const U8* data);
+
+        /* Assessors */
+        inline U16 getScanline(void) { return scanline; }
+        inline U16 getDot(void) { return dot; }
+        inline U64 getFrameCount(void) { return frameCount; }
+        inline U64 getDotCount(void) { return dotCount; }
+        inline U16 getRenderInterval(void) { return renderInterval; }
+        inline bool isFrameRendered(void) { return renderingFrame; }
+        inline bool isOutputSuppressed(void) { return outputSuppressed; }
+        inline bool isNMIAsserted(void) { return (status & PPUFlags::STATUS_VBLANK) && (ctrl & PPUFlags::CTRL_NMI_ENABLE); }
+        U32 dotsUntil(U16 targetScanline, U16 targetDot);
+        const U8* getFrameBuffer(void);
+        U64 getFrameBufferFrame(void);
+        inline U8* getNameTables(void) { return reinterpret_cast<U8*>(&nameTables); }
+        inline U8* getOAM(void) { return oam.data(); }
+        inline U8* getCHRRAM(void) { return chrRam.empty() ? nullptr : chrRam.data(); }
+        inline std::shared_ptr<const Cartridge> getCartridge(void) { return cartridge; }
+
+        /* Modifiers */
+        void setMirroring(Mirroring mode);
+        void insertCartridge(std::shared_ptr<const Cartridge> cart);
+
+        /**
+         * Frame skip: generate pixels for every Nth frame only (1: every frame,
+         * PPU_RENDER_NEVER: never). Vblank, sprite 0 hit and sprite overflow are
+         * still computed for skipped frames, so $2002 reads are unaffected. The
+         * frame buffer is released while the interval is PPU_RENDER_NEVER.
+         */
+        void setRenderInterval(U16 interval);
+
+        /**
+         * Output suppression: no pixels are generated from the current frame on,
+         * without changing the render interval. Unlike PPU_RENDER_NEVER the frame
+         * buffer keeps the last rendered frame, so it can be toggled around
+         * frames that are never shown (rollback re-simulation) at no cost.
+         * Rendering resumes with the next frame.
+         */
+        void setOutputSuppressed(bool suppressed);
+
+        /**
+         * Pipelined rendering: while a pipeline is attached, pixels are not generated
+         * here. Register accesses are recorded with their dot timestamp and a worker
+         * thread replays them to render the frame. Status timing stays synchronous.
+         * The worker renders into a replica, so no frame buffer is kept here while
+         * attached; detaching restores it from the pipeline's last presented frame.
+         */
+        void attachPipeline(PPURenderPipeline* renderPipeline);
+        inline void attachDirtyPages(DirtyPages* pages) { dirtyPages = pages; }
+};
+
+
 #endif /* RP2C02 */
\ No newline at end of file
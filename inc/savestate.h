@@ -0,0 +1,119 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+/* Standard Headers */
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+/* Project Headers */
+#include "global.h"
+
+/* Save State Definitions */
+#define SAVESTATE_MAGIC                     (U32)(0x5353454E)   /* "NESS" */
+#define SAVESTATE_VERSION                   (U32)(4)
+
+
+/**
+ * Serializes machine state into a caller-provided buffer. A writer without a
+ * buffer only counts bytes, which is how the state size is determined.
+ *
+ * A fingerprint writer serializes for hashing rather than restoring: counters
+ * that only ever grow (cycles, dots, frames) are left out and cycle timestamps
+ * are stored relative to the CPU's cycle count, so the same machine state
+ * reached at different times serializes to the same bytes.
+ */
+class StateWriter
+{
+    private:
+        U8* buffer;
+        size_t capacity;
+        size_t offset;
+
+        bool fingerprint;
+        U64 timebase;
+
+    public:
+        StateWriter(U8* buf, size_t size) : buffer(buf), capacity(size), offset(0), fingerprint(false), timebase(0) {}
+
+        inline void write(const void* data, size_t size)
+        {
+            if(buffer && offset + size <= capacity)
+            {
+                std::memcpy(buffer + offset, data, size);
+            }
+
+            offset += size;
+        }
+
+        template<typename T>
+        inline void put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "state fields must be trivially copyable");
+            write(&value, sizeof(T));
+        }
+
+        /* Monotonic counter: left out of fingerprints */
+        inline void putCounter(U64 value)
+        {
+            if(!fingerprint)
+            {
+                put(value);
+            }
+        }
+
+        /* CPU cycle timestamp (all ones: never): relative to the timebase in fingerprints */
+        inline void putTimestamp(U64 value)
+        {
+            put((fingerprint && value != ~(U64)0) ? value - timebase : value);
+        }
+
+        /* Switches to fingerprint serialization, cpuCycle being the current CPU cycle count */
+        inline void setFingerprint(U64 cpuCycle) { fingerprint = true; timebase = cpuCycle; }
+
+        /* Assessors */
+        inline size_t size(void) { return offset; }
+        inline bool overflowed(void) { return offset > capacity; }
+};
+
+
+/**
+ * Deserializes machine state written by StateWriter.
+ */
+class StateReader
+{
+    private:
+        const U8* buffer;
+        size_t capacity;
+        size_t offset;
+
+    public:
+        StateReader(const U8* buf, size_t size) : buffer(buf), capacity(size), offset(0) {}
+
+        inline void read(void* data, size_t size)
+        {
+            if(offset + size <= capacity)
+            {
+                std::memcpy(data, buffer + offset, size);
+            }
+
+            offset += size;
+        }
+
+        template<typename T>
+        inline void get(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "state fields must be trivially copyable");
+            read(&value, sizeof(T));
+        }
+
+        /* Counterparts of StateWriter::putCounter/putTimestamp (never read from fingerprints) */
+        inline void getCounter(U64& value) { get(value); }
+        inline void getTimestamp(U64& value) { get(value); }
+
+        /* Assessors */
+        inline size_t size(void) { return offset; }
+        inline bool overflowed(void) { return offset > capacity; }
+};
+
+
+#endif /* SAVESTATE_H */
\ No newline at end of file
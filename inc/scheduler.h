@@ -0,0 +1,153 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* Standard Headers */
+#include <array>
+/* Project Headers */
+#include "global.h"
+
+/* Master Clock Definitions (NTSC: 21.477272 MHz) */
+#define MASTER_CYCLES_PER_CPU_CYCLE         (U64)(12)
+#define MASTER_CYCLES_PER_PPU_DOT           (U64)(4)
+#define EVENT_NEVER                         (U64)(0xFFFFFFFFFFFFFFFF)
+
+
+/* Timed event sources, one pending event each */
+enum class EventType : U8
+{
+    vblank,         /* PPU reaches scanline 241, dot 1 (vblank flag, NMI) */
+    apuFrameIRQ,    /* APU frame counter raises its IRQ (4-step mode) */
+    dmcIRQ,         /* DMC sample finishes */
+    mapperIRQ,      /* Cartridge scanline counter reaches zero */
+    count
+};
+
+
+/**
+ * Min-heap of event deadlines in master clock cycles. Every source has at most
+ * one pending event; scheduling it again moves the existing entry.
+ */
+class EventScheduler
+{
+    private:
+        static constexpr U8 EVENT_COUNT = static_cast<U8>(EventType::count);
+        static constexpr U8 NOT_QUEUED = 0xFF;
+
+        struct Event
+        {
+            U64 deadline;
+            EventType type;
+        };
+
+        std::array<Event, EVENT_COUNT> heap;
+        std::array<U8, EVENT_COUNT> position;   /* Heap index of each source, NOT_QUEUED if none */
+        U8 size;
+
+        inline void place(U8 index, const Event& event)
+        {
+            heap[index] = event;
+            position[static_cast<U8>(event.type)] = index;
+        }
+
+        inline void siftUp(U8 index)
+        {
+            Event event = heap[index];
+            while(index > 0 && heap[(index - 1) / 2].deadline > event.deadline)
+            {
+                place(index, heap[(index - 1) / 2]);
+                index = (index - 1) / 2;
+            }
+            place(index, event);
+        }
+
+        inline void siftDown(U8 index)
+        {
+            Event event = heap[index];
+            while(true)
+            {
+                U8 child = index * 2 + 1;
+                if(child >= size)
+                {
+                    break;
+                }
+                if(child + 1 < size && heap[child + 1].deadline < heap[child].deadline)
+                {
+                    child++;
+                }
+                if(heap[child].deadline >= event.deadline)
+                {
+                    break;
+                }
+                place(index, heap[child]);
+                index = child;
+            }
+            place(index, event);
+        }
+
+        inline void removeAt(U8 index)
+        {
+            position[static_cast<U8>(heap[index].type)] = NOT_QUEUED;
+            size--;
+
+            if(index < size)
+            {
+                place(index, heap[size]);
+                siftDown(index);
+                siftUp(position[static_cast<U8>(heap[index].type)]);
+            }
+        }
+
+    public:
+        EventScheduler() { clear(); }
+
+        inline void clear(void)
+        {
+            position.fill(NOT_QUEUED);
+            size = 0;
+        }
+
+        /* Schedules (or moves) the source's event; EVENT_NEVER cancels it */
+        inline void schedule(EventType type, U64 deadline)
+        {
+            cancel(type);
+
+            if(deadline != EVENT_NEVER)
+            {
+                place(size, {deadline, type});
+                siftUp(size++);
+            }
+        }
+
+        inline void cancel(EventType type)
+        {
+            U8 index = position[static_cast<U8>(type)];
+            if(index != NOT_QUEUED)
+            {
+                removeAt(index);
+            }
+        }
+
+        /* Removes the earliest event if it is due at time now */
+        inline bool pop(U64 now, EventType* type)
+        {
+            if(size == 0 || heap[0].deadline > now)
+            {
+                return false;
+            }
+
+            *type = heap[0].type;
+            removeAt(0);
+            return true;
+        }
+
+        /* Assessors */
+        inline U64 getNextDeadline(void) { return size ? heap[0].deadline : EVENT_NEVER; }
+        inline U64 getDeadline(EventType type)
+        {
+            U8 index = position[static_cast<U8>(type)];
+            return (index != NOT_QUEUED) ? heap[index].deadline : EVENT_NEVER;
+        }
+};
+
+
+#endif /* SCHEDULER_H */
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef STATE_PUBLISHER_H
+#define STATE_PUBLISHER_H
+
+/* Standard Headers */
+#include <atomic>
+#include <string>
+/* Project Headers */
+#include "global.h"
+#include "nesmemory.h"
+#include "rp2a03.h"
+#include "rp2c02.h"
+
+/* Shared Memory Definitions */
+#define SHM_STATE_MAGIC                     (U32)(0x4D48534E)   /* "NSHM" */
+#define SHM_STATE_VERSION                   (U32)(2)
+#define SHM_RAM_SIZE                        (U16)(0x0800)
+#define SHM_READ_RETRIES                    (U32)(64)
+
+
+/**
+ * Layout of the shared memory segment. Fixed size, no pointers, so consumers in
+ * any language can map it. The sequence counter is a seqlock: it is odd while
+ * the emulator writes a snapshot and bumped to the next even value when done.
+ * With frame skip the buffer keeps the last rendered frame; frameNumber says
+ * which one it is.
+ */
+struct SharedState
+{
+    std::atomic<U32> sequence;
+    U32 magic;
+    U32 version;
+    U32 frameValid;             /* 1 if frameBuffer holds a rendered frame */
+    U64 frameCount;             /* PPU frames completed */
+    U64 frameNumber;            /* frameCount of the frame in frameBuffer (older on skipped frames) */
+    U64 cycles;                 /* CPU cycles elapsed */
+    U16 PC;
+    U8 SP;
+    U8 A;
+    U8 X;
+    U8 Y;
+    U8 status;
+    U8 reserved;
+    U8 ram[SHM_RAM_SIZE];       /* Internal RAM 0x0000 - 0x07FF */
+    U8 frameBuffer[PPU_FRAME_BUFFER_SIZE];  /* 6-bit palette indices, then per-scanline emphasis */
+};
+
+/* Consistent copy of the published fields (sequence excluded) */
+struct StateSnapshot
+{
+    U32 frameValid;
+    U64 frameCount;
+    U64 frameNumber;
+    U64 cycles;
+    U16 PC;
+    U8 SP;
+    U8 A;
+    U8 X;
+    U8 Y;
+    U8 status;
+    U8 ram[SHM_RAM_SIZE];
+    U8 frameBuffer[PPU_FRAME_BUFFER_SIZE];
+};
+
+
+/**
+ * Publishes CPU registers, RAM and the latest frame of one console into a POSIX
+ * shared memory segment. Publishing never blocks and makes no syscalls. The
+ * segment is unlinked by the publisher that created it, not by ones that attached.
+ */
+class StatePublisher
+{
+    private:
+        std::string name;
+        SharedState* shared;
+        bool owner;         /* Created the segment, so unlinks it when done */
+
+    public:
+        explicit StatePublisher(const std::string& segmentName);
+        ~StatePublisher();
+
+        void publish(RP2A03& cpu, NESMemory& memory, RP2C02& ppu);
+
+        /* Assessors */
+        inline bool isOpen(void) { return shared != nullptr; }
+};
+
+
+/**
+ * Reads snapshots published by a StatePublisher, possibly from another process.
+ */
+class StateSubscriber
+{
+    private:
+        const SharedState* shared;
+
+    public:
+        explicit StateSubscriber(const std::string& segmentName);
+        ~StateSubscriber();
+
+        bool read(StateSnapshot* snapshot);
+
+        /* Assessors */
+        inline bool isOpen(void) { return shared != nullptr; }
+};
+
+
+#endif /* STATE_PUBLISHER_H */
\ No newline at end of file
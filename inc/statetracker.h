@@ -0,0 +1,67 @@
+#ifndef STATE_TRACKER_H
+#define STATE_TRACKER_H
+
+/* Standard Headers */
+#include <array>
+#include <cstddef>
+#include <vector>
+/* Project Headers */
+#include "dirtypages.h"
+#include "global.h"
+#include "nes.h"
+
+/* State Delta Definitions */
+#define STATEDELTA_MAGIC                    (U32)(0x4453454E)   /* "NESD" */
+
+
+/**
+ * Incremental state fingerprinting and deltas on top of the bus's dirty page
+ * bitmap (see dirtypages.h).
+ *
+ * hash() returns a 64-bit hash of the full machine state: the per-page hashes
+ * are cached and only pages written since the previous call are rehashed, while
+ * the small remainder (CPU, PPU and I/O registers, palette) is hashed every time.
+ * The timebase is left out (cycle, dot and frame counters; timestamps count from
+ * the current cycle), so equal states reached along different paths hash equal.
+ * Deltas still carry the full timebase.
+ *
+ * saveDelta() writes the registers and the pages written since the previous
+ * delta; applying it with loadDelta() to the state the previous delta produced
+ * yields the current state. The first delta holds every page.
+ *
+ * Collecting clears the bus's bitmap, so use one tracker per console. Memory
+ * changed behind the bus (e.g. through NES::getRAM()) must be reported with
+ * Bus::markAllDirty().
+ */
+class StateTracker
+{
+    private:
+        NES& console;
+
+        /* Cached page hashes and their combination */
+        std::array<U64, STATE_PAGE_COUNT> pageHashes;
+        U64 combinedPageHash;
+
+        /* Pages written since the last delta */
+        DirtyPages deltaPages;
+
+        /* Register serialization scratch */
+        std::vector<U8> registers;
+
+        void collect(void);
+        U64 hashPage(U16 page);
+        size_t saveRegisters(bool fingerprint);
+
+    public:
+        StateTracker(NES& nes);
+        ~StateTracker();
+
+        U64 hash(void);
+
+        /* State deltas (saveDelta returns the delta size, larger than size if it didn't fit) */
+        size_t saveDelta(U8* buffer, size_t size);
+        bool loadDelta(const U8* buffer, size_t size);
+};
+
+
+#endif /* STATE_TRACKER_H */
\ No newline at end of file
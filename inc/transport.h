@@ -0,0 +1,108 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+/* Standard Headers */
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+/* Project Headers */
+#include "global.h"
+
+/* Transport Definitions */
+#define TRANSPORT_MAX_PACKET                (size_t)(512)
+
+
+/**
+ * Unreliable, unordered datagram link between two netplay peers. Packets may be
+ * lost, duplicated or reordered; receive() never blocks.
+ */
+class Transport
+{
+    public:
+        virtual ~Transport() {}
+
+        virtual bool send(const U8* data, size_t size) = 0;
+
+        /* Copies the next pending packet into buffer, returns its size (0: none pending) */
+        virtual size_t receive(U8* buffer, size_t size) = 0;
+};
+
+
+/**
+ * UDP socket bound to a local port that talks to a single remote address
+ * (e.g. 127.0.0.1 for loopback testing).
+ */
+class UDPTransport : public Transport
+{
+    private:
+        int socketHandle;
+        std::array<U8, 16> remoteAddress;   /* struct sockaddr_in */
+
+    public:
+        UDPTransport(U16 localPort, const std::string& remoteHost, U16 remotePort);
+        ~UDPTransport();
+
+        bool send(const U8* data, size_t size) override;
+        size_t receive(U8* buffer, size_t size) override;
+
+        /* Assessors */
+        inline bool isOpen(void) { return socketHandle >= 0; }
+};
+
+
+/**
+ * In-process link between two endpoints with injected latency, jitter and
+ * packet loss. Each packet is delivered latency + [0, jitter] ms after it was
+ * sent, so jitter also reorders packets. Endpoints may be used from different
+ * threads.
+ */
+class FakeLink
+{
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Packet
+        {
+            Clock::time_point deliverAt;
+            std::vector<U8> data;
+        };
+
+        class Endpoint : public Transport
+        {
+            private:
+                FakeLink* link;
+                U8 side;
+
+            public:
+                Endpoint(FakeLink* fakeLink, U8 endpointSide) : link(fakeLink), side(endpointSide) {}
+
+                bool send(const U8* data, size_t size) override { return link->post(side ^ 0x01, data, size); }
+                size_t receive(U8* buffer, size_t size) override { return link->fetch(side, buffer, size); }
+        };
+
+        U32 latency;        /* ms */
+        U32 jitter;         /* ms */
+        double lossRate;    /* 0.0 - 1.0 */
+
+        std::array<std::vector<Packet>, 2> queues;  /* Packets in flight to each side */
+        std::array<Endpoint, 2> endpoints;
+        std::mt19937 random;
+        std::mutex lock;
+
+        bool post(U8 side, const U8* data, size_t size);
+        size_t fetch(U8 side, U8* buffer, size_t size);
+
+    public:
+        FakeLink(U32 latencyMs, U32 jitterMs, double loss = 0.0, U32 seed = 1);
+        ~FakeLink();
+
+        /* Side 0 and side 1 of the link */
+        inline Transport& getEndpoint(U8 side) { return endpoints[side & 0x01]; }
+};
+
+
+#endif /* TRANSPORT_H */
\ No newline at end of file
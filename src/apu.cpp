@@ -0,0 +1,194 @@
+#include "../inc/apu.h"
+
+#include <array>
+
+
+/* DMC bit periods in CPU cycles (NTSC), indexed by $4010 BIT0-3 */
+static const std::array<U16, 16> dmcRates =
+{
+    428, 380, 340, 320, 286, 254, 226, 214, 190, 160, 142, 128, 106, 84, 72, 54
+};
+
+
+APU::APU()
+{
+    reset(0);
+}
+
+APU::~APU(){}
+
+
+/**
+ * @brief Puts the APU into its power-up state, as if $4017 had been written with 0
+ *
+ */
+void APU::reset(U64 cpuCycle)
+{
+    frameIRQ = false;
+    dmcControl = 0;
+    dmcLength = 0;
+    dmcIRQ = false;
+    dmcEndCycle = APU_NEVER;
+
+    writeRegister(APU_REG_FRAME_COUNTER, 0, cpuCycle);
+}
+
+
+/**
+ * @brief Length of the current DMC sample in CPU cycles
+ *
+ */
+U64 APU::sampleCycles(void)
+{
+    U64 bytes = (U64)dmcLength * 16 + 1;
+    return bytes * 8 * dmcRates[dmcControl & APUFlags::DMC_RATE];
+}
+
+
+/**
+ * @brief Writes one of the interrupt related APU registers
+ *
+ * @param addr $4010, $4013, $4015 or $4017 (others are ignored)
+ * @param data Value written
+ * @param cpuCycle CPU cycle of the write
+ */
+void APU::writeRegister(U16 addr, U8 data, U64 cpuCycle)
+{
+    switch(addr)
+    {
+        case APU_REG_DMC_CONTROL:
+        {
+            dmcControl = data;
+            if(!(data & APUFlags::DMC_IRQ_ENABLE))
+            {
+                dmcIRQ = false;
+            }
+            break;
+        }
+        case APU_REG_DMC_LENGTH:
+        {
+            dmcLength = data;
+            break;
+        }
+        case APU_REG_STATUS:
+        {
+            dmcIRQ = false;
+
+            if(!(data & APUFlags::STATUS_DMC_ACTIVE))
+            {
+                dmcEndCycle = APU_NEVER;
+            }
+            else if(dmcEndCycle == APU_NEVER)
+            {
+                dmcEndCycle = cpuCycle + sampleCycles();
+            }
+            break;
+        }
+        case APU_REG_FRAME_COUNTER:
+        {
+            // The write restarts the sequence
+            frameControl = data;
+            if(data & APUFlags::FRAME_IRQ_INHIBIT)
+            {
+                frameIRQ = false;
+            }
+
+            bool irqEnabled = !(data & (APUFlags::FRAME_MODE_5STEP | APUFlags::FRAME_IRQ_INHIBIT));
+            frameIRQCycle = irqEnabled ? cpuCycle + APU_FRAME_IRQ_FIRST : APU_NEVER;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Reads $4015; acknowledges the frame IRQ
+ *
+ */
+U8 APU::readStatus(U64 cpuCycle)
+{
+    U8 data = 0;
+
+    if(dmcEndCycle != APU_NEVER && cpuCycle < dmcEndCycle)
+    {
+        data |= APUFlags::STATUS_DMC_ACTIVE;
+    }
+    if(frameIRQ)
+    {
+        data |= APUFlags::STATUS_FRAME_IRQ;
+    }
+    if(dmcIRQ)
+    {
+        data |= APUFlags::STATUS_DMC_IRQ;
+    }
+
+    frameIRQ = false;
+    return data;
+}
+
+
+/**
+ * @brief The frame counter reached the last step of the 4-step sequence
+ *
+ */
+void APU::frameCounterEvent(void)
+{
+    frameIRQ = true;
+    frameIRQCycle += APU_FRAME_IRQ_PERIOD;
+}
+
+
+/**
+ * @brief The DMC played its last sample byte: loop, or stop and raise the IRQ
+ *
+ */
+void APU::dmcEvent(void)
+{
+    if(dmcControl & APUFlags::DMC_LOOP)
+    {
+        dmcEndCycle += sampleCycles();
+        return;
+    }
+
+    dmcEndCycle = APU_NEVER;
+    if(dmcControl & APUFlags::DMC_IRQ_ENABLE)
+    {
+        dmcIRQ = true;
+    }
+}
+
+
+/**
+ * @brief Serializes the frame counter and DMC state
+ *
+ */
+void APU::saveState(StateWriter& state)
+{
+    state.put(frameControl);
+    state.put(frameIRQ);
+    state.putTimestamp(frameIRQCycle);
+    state.put(dmcControl);
+    state.put(dmcLength);
+    state.put(dmcIRQ);
+    state.putTimestamp(dmcEndCycle);
+}
+
+
+/**
+ * @brief Restores the frame counter and DMC state
+ *
+ */
+void APU::loadState(StateReader& state)
+{
+    state.get(frameControl);
+    state.get(frameIRQ);
+    state.getTimestamp(frameIRQCycle);
+    state.get(dmcControl);
+    state.get(dmcLength);
+    state.get(dmcIRQ);
+    state.getTimestamp(dmcEndCycle);
+}
\ No newline at end of file
@@ -1,12 +1,581 @@
-#include "../inc/bus.h"
-
-Bus::Bus()
-{
-    // The bus owns the NESMemory object
-    nes_memory = std::make_unique<NESMemory>();
-}
-
-Bus::~Bus(){}
-
-void Bus::writeToBus(U16 addr, U8 data){ (void)addr; (void)data; }
-U8 Bus::readFromBus(U16 addr){ (void)addr; return 0; }
\ No newline at end of file
+#include "../inc/bus.h"
+#include "../inc/rp2a03.h"
+
+Bus::Bus()
+{
+    // The bus owns the NESMemory object
+    nes_memory = InstanceArena<NESMemory>::instance().create();
+
+    // The PPU registers are mapped into CPU memory, so the bus owns the PPU too
+    ppu = InstanceArena<RP2C02>::instance().create();
+    ppu->attachDirtyPages(&dirtyPages);
+
+    controllerState.fill(0);
+    controllerShift.fill(0);
+    controllerStrobe = false;
+    pendingDMA = 0;
+
+    cpu = nullptr;
+    ppuSyncCycle = 0;
+    nmiPending = false;
+    mapperIRQ = false;
+    scanlineIRQ = BUS_NO_SCANLINE_IRQ;
+    scheduleVBlank();
+    scheduleAPU();
+}
+
+/**
+ * @brief Duplicates memory, PPU and controllers into new arena slots
+ *
+ * @details The cartridge is shared. The copy renders synchronously even if the
+ * original is pipelined, starting from the original's last presented frame.
+ */
+Bus::Bus(const Bus& other)
+{
+    nes_memory = InstanceArena<NESMemory>::instance().create(*other.nes_memory);
+
+    ppu = InstanceArena<RP2C02>::instance().create(*other.ppu);
+    ppu->attachPipeline(nullptr);
+    ppu->attachDirtyPages(&dirtyPages);
+
+    controllerState = other.controllerState;
+    controllerShift = other.controllerShift;
+    controllerStrobe = other.controllerStrobe;
+    pendingDMA = other.pendingDMA;
+
+    // The copy's console connects its own CPU
+    cpu = nullptr;
+    ppuSyncCycle = other.ppuSyncCycle;
+    scheduler = other.scheduler;
+    vblankFrame = other.vblankFrame;
+    apu = other.apu;
+    nmiPending = other.nmiPending;
+    mapperIRQ = other.mapperIRQ;
+    scanlineIRQ = other.scanlineIRQ;
+}
+
+Bus::~Bus()
+{
+    setPipelinedRendering(false);
+}
+
+void Bus::writeToBus(U16 addr, U8 data)
+{
+    if(addr >= MemoryMap::MEM_IO_REGISTER_1_BASE_ADDR && addr < MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR)
+    {
+        syncPPU();
+
+        // Enabling NMI during vblank is a rising edge too
+        bool nmiBefore = ppu->isNMIAsserted();
+        ppu->writeRegister(addr, data);
+        nmiPending |= !nmiBefore && ppu->isNMIAsserted();
+    }
+    else
+    {
+        if(addr == MemoryMap::MEM_IO_OAM_DMA_ADDR)
+        {
+            oamDMA(data);
+        }
+        else if(addr == APU_REG_DMC_CONTROL || addr == APU_REG_DMC_LENGTH || addr == APU_REG_STATUS || addr == APU_REG_FRAME_COUNTER)
+        {
+            apu.writeRegister(addr, data, getCPUCycle());
+            scheduleAPU();
+        }
+        else if(addr == MemoryMap::MEM_IO_CONTROLLER1_ADDR)
+        {
+            // While the strobe is high the shift registers keep reloading
+            controllerStrobe = data & 0x01;
+            if(controllerStrobe)
+            {
+                controllerShift = controllerState;
+            }
+        }
+
+        nes_memory->write(addr, data);
+
+        if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+        {
+            dirtyPages.mark(STATE_PAGE_RAM + ((addr & 0x07FF) >> 8));
+        }
+        else if(addr >= MemoryMap::MEM_SRAM_BASE_ADDR && addr < MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR)
+        {
+            dirtyPages.mark(STATE_PAGE_SRAM + ((addr - MemoryMap::MEM_SRAM_BASE_ADDR) >> 8));
+        }
+    }
+}
+
+U8 Bus::readFromBus(U16 addr)
+{
+    if(addr >= MemoryMap::MEM_IO_REGISTER_1_BASE_ADDR && addr < MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR)
+    {
+        syncPPU();
+        return ppu->readRegister(addr);
+    }
+    else if(addr == APU_REG_STATUS)
+    {
+        return apu.readStatus(getCPUCycle());
+    }
+    else if(addr == MemoryMap::MEM_IO_CONTROLLER1_ADDR || addr == MemoryMap::MEM_IO_CONTROLLER2_ADDR)
+    {
+        U8 port = addr - MemoryMap::MEM_IO_CONTROLLER1_ADDR;
+
+        if(controllerStrobe)
+        {
+            controllerShift[port] = controllerState[port];
+        }
+
+        // Buttons shift out BIT0 first; an empty register reads back 1s
+        U8 data = controllerShift[port] & 0x01;
+        controllerShift[port] = (controllerShift[port] >> 1) | 0x80;
+
+        return data | 0x40;
+    }
+
+    return nes_memory->read(addr);
+}
+
+
+/**
+ * @brief OAM DMA: copies CPU page $XX00 - $XXFF into OAM
+ *
+ * @details RAM, SRAM and ROM pages are copied in one go; I/O pages are read
+ * byte by byte through the bus. The CPU is halted afterwards (takeDMAStall)
+ * instead of emulating the 256 read/write pairs.
+ */
+void Bus::oamDMA(U8 page)
+{
+    // The PPU reads OAM while rendering, so it has to be current
+    syncPPU();
+
+    const U8* source = nes_memory->getPage(page);
+
+    if(source)
+    {
+        ppu->oamDMA(source);
+    }
+    else
+    {
+        std::array<U8, 256> buffer;
+        for(U16 i = 0; i < buffer.size(); i++)
+        {
+            buffer[i] = readFromBus((page << 8) | i);
+        }
+
+        ppu->oamDMA(buffer.data());
+    }
+
+    pendingDMA++;
+}
+
+
+/**
+ * @brief Returns and clears the CPU stall of the DMAs started since the last call
+ *
+ * @details Each DMA takes a halt cycle and 256 read/write pairs, plus an
+ * alignment cycle when it starts on an odd CPU cycle.
+ *
+ * @param cpuCycles CPU cycle count at which the DMA starts
+ */
+U16 Bus::takeDMAStall(U64 cpuCycles)
+{
+    U16 stall = 0;
+
+    for(; pendingDMA; pendingDMA--)
+    {
+        stall += 513 + ((cpuCycles + stall) & 0x01);
+    }
+
+    return stall;
+}
+
+
+/**
+ * @brief Inserts a cartridge, shared read-only with any other console running it
+ *
+ */
+void Bus::insertCartridge(std::shared_ptr<const Cartridge> cart)
+{
+    nes_memory->insertCartridge(cart);
+    ppu->insertCartridge(cart);
+
+    // The render worker's replica has to see the new pattern tables too
+    syncRenderPipeline();
+}
+
+
+/**
+ * @brief Catches the PPU up with the CPU
+ *
+ * @details Called before every PPU access and when an event is due, rather than
+ * after every instruction.
+ */
+void Bus::syncPPU(void)
+{
+    U64 target = getCPUCycle();
+    if(target <= ppuSyncCycle)
+    {
+        return;
+    }
+
+    for(U64 dots = (target - ppuSyncCycle) * 3; dots; dots--)
+    {
+        ppu->PPU_Cycle();
+    }
+
+    ppuSyncCycle = target;
+}
+
+
+/**
+ * @brief Current bus time: the CPU's cycle count (a bus without a CPU stands still)
+ *
+ */
+U64 Bus::getCPUCycle(void)
+{
+    return cpu ? cpu->getCycles() : ppuSyncCycle;
+}
+
+
+/**
+ * @brief Resets the PPU, APU and interrupt lines and rebuilds the event timeline
+ *
+ */
+void Bus::reset(void)
+{
+    ppuSyncCycle = getCPUCycle();
+    ppu->reset();
+    apu.reset(ppuSyncCycle);
+
+    nmiPending = false;
+    mapperIRQ = false;
+    scanlineIRQ = BUS_NO_SCANLINE_IRQ;
+
+    scheduler.clear();
+    scheduleVBlank();
+    scheduleAPU();
+}
+
+
+/**
+ * @brief Schedules the next time the PPU raises the vblank flag
+ *
+ * @details Predicted from the PPU's position, assuming rendering doesn't change
+ * (which moves the odd-frame skip); the event checks and reschedules itself.
+ */
+void Bus::scheduleVBlank(void)
+{
+    vblankFrame = ppu->getFrameCount();
+
+    U64 dots = ppu->dotsUntil(PPU_VBLANK_SCANLINE, 1);
+    scheduler.schedule(EventType::vblank, ppuSyncCycle * MASTER_CYCLES_PER_CPU_CYCLE + dots * MASTER_CYCLES_PER_PPU_DOT);
+}
+
+
+/**
+ * @brief Schedules the APU's next frame counter and DMC interrupts
+ *
+ */
+void Bus::scheduleAPU(void)
+{
+    U64 frameIRQ = apu.getFrameIRQCycle();
+    U64 dmcEnd = apu.getDMCEndCycle();
+
+    scheduler.schedule(EventType::apuFrameIRQ, (frameIRQ == APU_NEVER) ? EVENT_NEVER : frameIRQ * MASTER_CYCLES_PER_CPU_CYCLE);
+    scheduler.schedule(EventType::dmcIRQ, (dmcEnd == APU_NEVER) ? EVENT_NEVER : dmcEnd * MASTER_CYCLES_PER_CPU_CYCLE);
+}
+
+
+/**
+ * @brief Schedules the pending cartridge scanline IRQ, if any
+ *
+ */
+void Bus::scheduleScanline(void)
+{
+    if(scanlineIRQ == BUS_NO_SCANLINE_IRQ)
+    {
+        scheduler.cancel(EventType::mapperIRQ);
+        return;
+    }
+
+    U64 dots = ppu->dotsUntil(scanlineIRQ, BUS_SCANLINE_IRQ_DOT);
+    scheduler.schedule(EventType::mapperIRQ, ppuSyncCycle * MASTER_CYCLES_PER_CPU_CYCLE + dots * MASTER_CYCLES_PER_PPU_DOT);
+}
+
+
+/**
+ * @brief CPU cycle at which the next event is due
+ *
+ */
+U64 Bus::getNextEventCycle(void)
+{
+    U64 deadline = scheduler.getNextDeadline();
+    if(deadline == EVENT_NEVER)
+    {
+        return EVENT_NEVER;
+    }
+
+    return (deadline + MASTER_CYCLES_PER_CPU_CYCLE - 1) / MASTER_CYCLES_PER_CPU_CYCLE;
+}
+
+
+/**
+ * @brief Handles every event that is due by the CPU's cycle count
+ *
+ * @details Each source updates its interrupt line and schedules its next firing.
+ */
+void Bus::runEvents(void)
+{
+    U64 now = getCPUCycle() * MASTER_CYCLES_PER_CPU_CYCLE;
+    EventType type;
+
+    while(scheduler.pop(now, &type))
+    {
+        switch(type)
+        {
+            case EventType::vblank:
+            {
+                syncPPU();
+
+                // Vblank just started, so an asserted NMI output is a rising edge
+                if(ppu->getFrameCount() != vblankFrame && ppu->isNMIAsserted())
+                {
+                    nmiPending = true;
+                }
+
+                scheduleVBlank();
+                break;
+            }
+            case EventType::apuFrameIRQ:
+            {
+                apu.frameCounterEvent();
+                scheduleAPU();
+                break;
+            }
+            case EventType::dmcIRQ:
+            {
+                apu.dmcEvent();
+                scheduleAPU();
+                break;
+            }
+            case EventType::mapperIRQ:
+            {
+                syncPPU();
+                mapperIRQ = true;
+                scanlineIRQ = BUS_NO_SCANLINE_IRQ;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Takes a latched NMI edge
+ *
+ * @return true if the CPU has to enter the NMI handler
+ */
+bool Bus::takeNMI(void)
+{
+    bool pending = nmiPending;
+    nmiPending = false;
+    return pending;
+}
+
+
+/**
+ * @brief Raises the IRQ line when the PPU reaches dot 260 of a scanline
+ *
+ * @param scanline Scanline (0 - 261), or BUS_NO_SCANLINE_IRQ to cancel
+ */
+void Bus::setScanlineIRQ(U16 scanline)
+{
+    scanlineIRQ = scanline;
+    scheduleScanline();
+}
+
+
+/**
+ * @brief Releases the cartridge's IRQ line
+ *
+ */
+void Bus::acknowledgeScanlineIRQ(void)
+{
+    mapperIRQ = false;
+}
+
+
+/**
+ * @brief Enables or disables pipelined PPU rendering
+ *
+ * @details The worker starts from a copy of the current PPU state and the PPU
+ * here drops its frame buffer. Disabling waits for the worker to finish the
+ * frame in flight and hands its last frame back to the PPU.
+ */
+void Bus::setPipelinedRendering(bool enable)
+{
+    if(enable && !renderPipeline)
+    {
+        renderPipeline = std::make_unique<PPURenderPipeline>(*ppu);
+        ppu->attachPipeline(renderPipeline.get());
+    }
+    else if(!enable && renderPipeline)
+    {
+        renderPipeline->finish();
+        ppu->attachPipeline(nullptr);
+        renderPipeline.reset();
+    }
+}
+
+
+/**
+ * @brief Brings the render worker's replica up to the PPU after it was restored
+ *
+ * @details The copy goes through the command log, so the worker keeps running
+ * and finishes the frame in flight first. Does nothing when not pipelined.
+ */
+void Bus::syncRenderPipeline(void)
+{
+    if(renderPipeline)
+    {
+        renderPipeline->recordRestore(*ppu);
+    }
+}
+
+
+/**
+ * @brief Serializes memory, PPU and controller state
+ *
+ */
+void Bus::saveState(StateWriter& state)
+{
+    nes_memory->saveState(state);
+    ppu->saveState(state);
+
+    saveBusState(state);
+}
+
+
+/**
+ * @brief Serializes everything except the state pages (see dirtypages.h)
+ *
+ */
+void Bus::saveRegisters(StateWriter& state)
+{
+    nes_memory->saveRegisters(state);
+    ppu->saveRegisters(state);
+
+    saveBusState(state);
+}
+
+
+/**
+ * @brief Restores memory, PPU and controller state
+ *
+ */
+void Bus::loadState(StateReader& state)
+{
+    nes_memory->loadState(state);
+    ppu->loadState(state);
+
+    loadBusState(state);
+
+    dirtyPages.markAll();
+    syncRenderPipeline();
+}
+
+
+/**
+ * @brief Restores everything except the state pages (see dirtypages.h)
+ *
+ * @details The caller restores the pages, then calls syncRenderPipeline().
+ */
+void Bus::loadRegisters(StateReader& state)
+{
+    nes_memory->loadRegisters(state);
+    ppu->loadRegisters(state);
+
+    loadBusState(state);
+}
+
+
+/**
+ * @brief Serializes controllers, interrupt lines and the APU
+ *
+ */
+void Bus::saveBusState(StateWriter& state)
+{
+    state.put(controllerShift);
+    state.put(controllerStrobe);
+    state.putTimestamp(ppuSyncCycle);
+    apu.saveState(state);
+    state.put(nmiPending);
+    state.put(mapperIRQ);
+    state.put(scanlineIRQ);
+}
+
+
+/**
+ * @brief Restores controllers, interrupt lines and the APU, then rebuilds the
+ * event timeline from the restored PPU and APU
+ *
+ */
+void Bus::loadBusState(StateReader& state)
+{
+    state.get(controllerShift);
+    state.get(controllerStrobe);
+    state.getTimestamp(ppuSyncCycle);
+    apu.loadState(state);
+    state.get(nmiPending);
+    state.get(mapperIRQ);
+    state.get(scanlineIRQ);
+
+    scheduler.clear();
+    scheduleVBlank();
+    scheduleAPU();
+    scheduleScanline();
+}
+
+
+/**
+ * @brief Returns the state pages written since the last call and clears the bitmap
+ *
+ */
+DirtyPages Bus::collectDirtyPages(void)
+{
+    DirtyPages pages = dirtyPages;
+    dirtyPages.clear();
+    return pages;
+}
+
+
+/**
+ * @brief Resolves a state page to its 256 bytes of memory
+ *
+ * @return nullptr for CHR RAM pages on boards with CHR ROM
+ */
+U8* Bus::getStatePage(U16 page)
+{
+    if(page < STATE_PAGE_SRAM)
+    {
+        return nes_memory->getRAM() + (page - STATE_PAGE_RAM) * STATE_PAGE_SIZE;
+    }
+    else if(page < STATE_PAGE_NAMETABLE)
+    {
+        return nes_memory->getSRAM() + (page - STATE_PAGE_SRAM) * STATE_PAGE_SIZE;
+    }
+    else if(page < STATE_PAGE_OAM)
+    {
+        return ppu->getNameTables() + (page - STATE_PAGE_NAMETABLE) * STATE_PAGE_SIZE;
+    }
+    else if(page == STATE_PAGE_OAM)
+    {
+        return ppu->getOAM();
+    }
+
+    U8* chrRam = ppu->getCHRRAM();
+    return chrRam ? chrRam + (page - STATE_PAGE_CHR_RAM) * STATE_PAGE_SIZE : nullptr;
+}
\ No newline at end of file
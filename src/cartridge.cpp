@@ -0,0 +1,76 @@
+#include "../inc/cartridge.h"
+
+#include <fstream>
+#include <iterator>
+
+
+/**
+ * @brief Parses an iNES image
+ *
+ * @details Only mapper 0 (NROM) boards are supported.
+ *
+ * @param data iNES file contents
+ * @param size Size of the file in bytes
+ *
+ * @return Shared cartridge, or nullptr if the image can't be used
+ */
+std::shared_ptr<const Cartridge> loadINES(const U8* data, size_t size)
+{
+    if(!data || size < INES_HEADER_SIZE || data[0] != 'N' || data[1] != 'E' || data[2] != 'S' || data[3] != 0x1A)
+    {
+        return nullptr;
+    }
+
+    size_t prgSize = data[4] * INES_PRG_BANK_SIZE;
+    size_t chrSize = data[5] * INES_CHR_BANK_SIZE;
+    U8 flags6 = data[6];
+    U8 flags7 = data[7];
+    U8 mapper = (flags7 & 0xF0) | (flags6 >> 4);
+
+    if(mapper != 0 || prgSize == 0 || prgSize > 2 * INES_PRG_BANK_SIZE || chrSize > INES_CHR_BANK_SIZE)
+    {
+        return nullptr;
+    }
+
+    // Skip the header, and the trainer if present
+    size_t offset = INES_HEADER_SIZE + ((flags6 & 0x04) ? INES_TRAINER_SIZE : 0);
+    if(size < offset + prgSize + chrSize)
+    {
+        return nullptr;
+    }
+
+    auto cart = std::make_shared<Cartridge>();
+    cart->prgRom.assign(data + offset, data + offset + prgSize);
+    cart->chrRom.assign(data + offset + prgSize, data + offset + prgSize + chrSize);
+
+    if(flags6 & 0x08)
+    {
+        cart->mirroring = Mirroring::fourScreen;
+    }
+    else
+    {
+        cart->mirroring = (flags6 & 0x01) ? Mirroring::vertical : Mirroring::horizontal;
+    }
+
+    return cart;
+}
+
+
+/**
+ * @brief Reads and parses an iNES file
+ *
+ * @param path Path to the .nes file
+ *
+ * @return Shared cartridge, or nullptr if the file can't be read or used
+ */
+std::shared_ptr<const Cartridge> loadINESFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+    {
+        return nullptr;
+    }
+
+    std::vector<U8> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return loadINES(contents.data(), contents.size());
+}
\ No newline at end of file
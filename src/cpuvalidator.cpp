@@ -0,0 +1,487 @@
+#include "../inc/cpuvalidator.h"
+
+#include <cstdio>
+
+
+/**
+ * @brief Registers of the reference CPU
+ *
+ */
+static CPURegisters captureRegisters(RP2A03& cpu)
+{
+    return {cpu.getPC(), cpu.getSP(), cpu.getA(), cpu.getX(), cpu.getY(), cpu.getStatus(), cpu.getCycles()};
+}
+
+
+/**
+ * @brief Registers of a lockstep lane
+ *
+ */
+static CPURegisters captureRegisters(RP2A03Lockstep& cpu, U32 lane)
+{
+    return {cpu.getPC(lane), cpu.getSP(lane), cpu.getA(lane), cpu.getX(lane), cpu.getY(lane), cpu.getStatus(lane), cpu.getCycles(lane)};
+}
+
+
+/**
+ * @brief Formats the divergence as a short multi-line report
+ *
+ */
+std::string CPUDivergence::report(void) const
+{
+    if(lane == VALIDATOR_NO_LANE)
+    {
+        return "No divergence\n";
+    }
+
+    char line[128];
+    std::string text;
+
+    std::snprintf(line, sizeof(line), "Divergence at instruction %llu, lane %u: %s ($%02X $%02X $%02X)\n",
+                  static_cast<unsigned long long>(instruction), lane, RP2A03::getMnemonic(opCode).c_str(),
+                  opCode, operandBytes[0], operandBytes[1]);
+    text += line;
+    text += "            PC    SP  A   X   Y   P   cycles\n";
+
+    const char* names[3] = {"before", "reference", "candidate"};
+    const CPURegisters* rows[3] = {&before, &reference, &candidate};
+    for(U32 i = 0; i < 3; i++)
+    {
+        const CPURegisters& r = *rows[i];
+        std::snprintf(line, sizeof(line), "%-10s  %04X  %02X  %02X  %02X  %02X  %02X  %llu\n",
+                      names[i], r.PC, r.SP, r.A, r.X, r.Y, r.status, static_cast<unsigned long long>(r.cycles));
+        text += line;
+    }
+
+    std::string differs;
+    differs += (reference.PC != candidate.PC) ? " PC" : "";
+    differs += (reference.SP != candidate.SP) ? " SP" : "";
+    differs += (reference.A != candidate.A) ? " A" : "";
+    differs += (reference.X != candidate.X) ? " X" : "";
+    differs += (reference.Y != candidate.Y) ? " Y" : "";
+    differs += (reference.status != candidate.status) ? " P" : "";
+    differs += (reference.cycles != candidate.cycles) ? " cycles" : "";
+    if(!differs.empty())
+    {
+        text += "registers differ:" + differs + "\n";
+    }
+
+    if(ramAddr != VALIDATOR_NO_ADDR)
+    {
+        std::snprintf(line, sizeof(line), "RAM $%04X: reference $%02X, candidate $%02X\n", ramAddr, referenceByte, candidateByte);
+        text += line;
+    }
+
+    return text;
+}
+
+
+LockstepValidator::LockstepValidator(std::shared_ptr<const Cartridge> cart, U32 lanes) :
+    cartridge(std::move(cart)), laneCount((lanes > LOCKSTEP_LANES) ? LOCKSTEP_LANES : lanes)
+{
+    instructionCount = 0;
+    divergence = {};
+    divergence.lane = VALIDATOR_NO_LANE;
+
+    for(U32 lane = 0; lane < laneCount; lane++)
+    {
+        reference.push_back(InstanceArena<NES>::instance().create());
+        reference.back()->insertCartridge(cartridge);
+    }
+
+    candidate = std::make_unique<RP2A03Lockstep>();
+    candidate->insertCartridge(cartridge);
+    candidate->setActiveLanes((laneCount == LOCKSTEP_LANES) ? ~static_cast<LaneMask>(0) : ((static_cast<LaneMask>(1) << laneCount) - 1));
+
+    syncLanes();
+}
+
+LockstepValidator::~LockstepValidator(){}
+
+
+/**
+ * @brief Copies a reference console into its lockstep lane and device console
+ *
+ */
+void LockstepValidator::loadCandidate(U32 lane)
+{
+    NES& console = *reference[lane];
+
+    candidate->loadLane(lane, *console.getCPU(), console.getRAM());
+
+    if(lane < devices.size())
+    {
+        devices[lane] = console.clone();
+    }
+    else
+    {
+        devices.push_back(console.clone());
+    }
+
+    candidate->attachBus(lane, devices[lane]->getBus());
+}
+
+
+/**
+ * @brief Copies every reference console into its lockstep lane
+ *
+ */
+void LockstepValidator::syncLanes(void)
+{
+    for(U32 lane = 0; lane < laneCount; lane++)
+    {
+        loadCandidate(lane);
+    }
+}
+
+
+/**
+ * @brief Executes one instruction on both engines, on every lane
+ *
+ */
+void LockstepValidator::stepEngines(void)
+{
+    for(U32 lane = 0; lane < laneCount; lane++)
+    {
+        // Device reads see the same bus time as the reference's
+        devices[lane]->getCPU()->setCycles(candidate->getCycles(lane));
+        reference[lane]->getCPU()->CPU_Cycle();
+    }
+
+    candidate->step();
+    instructionCount++;
+}
+
+
+/**
+ * @brief Compares registers and internal RAM of every lane
+ *
+ * @param lane First mismatching lane
+ * @param ramAddr First mismatching RAM byte of that lane, or VALIDATOR_NO_ADDR
+ *
+ * @return false on a mismatch
+ */
+bool LockstepValidator::lanesMatch(U32* lane, U32* ramAddr)
+{
+    for(U32 l = 0; l < laneCount; l++)
+    {
+        CPURegisters ref = captureRegisters(*reference[l]->getCPU());
+        CPURegisters cand = captureRegisters(*candidate, l);
+
+        if(ref.PC != cand.PC || ref.SP != cand.SP || ref.A != cand.A || ref.X != cand.X ||
+           ref.Y != cand.Y || ref.status != cand.status || ref.cycles != cand.cycles)
+        {
+            *lane = l;
+            *ramAddr = VALIDATOR_NO_ADDR;
+            return false;
+        }
+    }
+
+    // Address-major, so the striped lockstep RAM is read sequentially
+    std::vector<const U8*> ram(laneCount);
+    for(U32 l = 0; l < laneCount; l++)
+    {
+        ram[l] = reference[l]->getRAM();
+    }
+
+    for(U16 addr = 0; addr < LOCKSTEP_RAM_SIZE; addr++)
+    {
+        for(U32 l = 0; l < laneCount; l++)
+        {
+            if(ram[l][addr] != candidate->readRAM(l, addr))
+            {
+                *lane = l;
+                *ramAddr = addr;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Reads a byte without side effects (I/O reads as zero)
+ *
+ */
+U8 LockstepValidator::peek(U32 lane, U16 addr)
+{
+    if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+    {
+        return reference[lane]->getRAM()[addr & 0x07FF];
+    }
+    else if(addr >= MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR && !cartridge->prgRom.empty())
+    {
+        return cartridge->prgRom[(addr - MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR) % cartridge->prgRom.size()];
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Fills in the divergence report for a lane
+ *
+ * @param before Registers before the diverging instruction
+ * @param instruction Instructions executed before it
+ */
+void LockstepValidator::recordDivergence(U32 lane, U32 ramAddr, const CPURegisters& before, U64 instruction)
+{
+    // The opcode is fetched after PC is incremented (RP2A03::fetch)
+    U16 opAddr = before.PC + 1 + MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR;
+
+    divergence.instruction = instruction;
+    divergence.lane = lane;
+    divergence.opCode = peek(lane, opAddr);
+    divergence.operandBytes[0] = peek(lane, opAddr + 1);
+    divergence.operandBytes[1] = peek(lane, opAddr + 2);
+    divergence.before = before;
+    divergence.reference = captureRegisters(*reference[lane]->getCPU());
+    divergence.candidate = captureRegisters(*candidate, lane);
+    divergence.ramAddr = ramAddr;
+    divergence.referenceByte = (ramAddr != VALIDATOR_NO_ADDR) ? reference[lane]->getRAM()[ramAddr] : 0;
+    divergence.candidateByte = (ramAddr != VALIDATOR_NO_ADDR) ? candidate->readRAM(lane, ramAddr) : 0;
+}
+
+
+/**
+ * @brief Runs a number of instructions on both engines
+ *
+ * @param compareEach Compare after every instruction and record the divergence;
+ * otherwise only compare at the end
+ *
+ * @return false on a mismatch
+ */
+bool LockstepValidator::runBlock(U64 instructions, bool compareEach)
+{
+    std::vector<CPURegisters> before(compareEach ? laneCount : 0);
+    U32 lane;
+    U32 ramAddr;
+
+    for(U64 i = 0; i < instructions; i++)
+    {
+        for(U32 l = 0; l < before.size(); l++)
+        {
+            before[l] = captureRegisters(*reference[l]->getCPU());
+        }
+
+        stepEngines();
+
+        if(compareEach && !lanesMatch(&lane, &ramAddr))
+        {
+            recordDivergence(lane, ramAddr, before[lane], instructionCount - 1);
+            return false;
+        }
+    }
+
+    return compareEach || lanesMatch(&lane, &ramAddr);
+}
+
+
+/**
+ * @brief Runs both engines until they diverge or the instruction count is reached
+ *
+ * @param blockLength Instructions between comparisons. A mismatching block is
+ * rewound and replayed instruction by instruction, so the report is exact either way.
+ * If the replay runs clean, the block's first mismatching lane and RAM byte are
+ * reported instead, with the registers of the block's start.
+ *
+ * @return false on divergence (see getDivergence())
+ */
+bool LockstepValidator::run(U64 instructions, U32 blockLength)
+{
+    if(hasDiverged())
+    {
+        return false;
+    }
+
+    blockLength = blockLength ? blockLength : 1;
+
+    // A reference changed without syncLanes() shows up before any instruction runs
+    U32 lane;
+    U32 ramAddr;
+    if(!lanesMatch(&lane, &ramAddr))
+    {
+        recordDivergence(lane, ramAddr, captureRegisters(*reference[lane]->getCPU()), instructionCount);
+        return false;
+    }
+
+    std::vector<InstanceArena<NES>::Pointer> checkpoint(laneCount);
+
+    while(instructions)
+    {
+        U64 block = (instructions < blockLength) ? instructions : blockLength;
+
+        if(blockLength == 1)
+        {
+            if(!runBlock(1, true))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            U64 start = instructionCount;
+            for(U32 lane = 0; lane < laneCount; lane++)
+            {
+                checkpoint[lane] = reference[lane]->clone();
+            }
+
+            if(!runBlock(block, false))
+            {
+                // Block-level report, kept if the replay doesn't reproduce the mismatch
+                lanesMatch(&lane, &ramAddr);
+                recordDivergence(lane, ramAddr, captureRegisters(*checkpoint[lane]->getCPU()), start);
+                CPUDivergence blockDivergence = divergence;
+
+                // Both engines agreed at the checkpoint: rewind and find the instruction
+                for(U32 l = 0; l < laneCount; l++)
+                {
+                    reference[l] = std::move(checkpoint[l]);
+                }
+
+                syncLanes();
+                instructionCount = start;
+
+                if(runBlock(block, true))
+                {
+                    divergence = blockDivergence;
+                }
+
+                return false;
+            }
+        }
+
+        instructions -= block;
+    }
+
+    return true;
+}
+
+
+/******************************************************************
+ *                     Instruction Fuzzer                         *
+ ******************************************************************/
+
+InstructionFuzzer::InstructionFuzzer(U64 seed) : random(seed)
+{
+    for(U16 op = 0; op < 256; op++)
+    {
+        if(RP2A03::getMnemonic(op) != "NII")
+        {
+            opCodes.push_back(op);
+        }
+    }
+}
+
+
+/**
+ * @brief Uniformly random byte
+ *
+ */
+U8 InstructionFuzzer::randomByte(void)
+{
+    return static_cast<U8>(random());
+}
+
+
+/**
+ * @brief High byte of a random absolute address: mostly internal RAM, some I/O and ROM
+ *
+ */
+U8 InstructionFuzzer::randomAddressHigh(void)
+{
+    U32 pick = random() % 100;
+
+    if(pick < 70)
+    {
+        return randomByte() & 0x07;
+    }
+    else if(pick < 80)
+    {
+        return 0x20 | (randomByte() & 0x1F);
+    }
+    else if(pick < 85)
+    {
+        return 0x40;
+    }
+
+    return 0x80 | randomByte();
+}
+
+
+/**
+ * @brief Builds a 32 KB PRG ROM cartridge holding a random instruction stream
+ *
+ */
+std::shared_ptr<const Cartridge> InstructionFuzzer::generateCartridge(void)
+{
+    auto cart = std::make_shared<Cartridge>();
+    cart->prgRom.resize(2 * INES_PRG_BANK_SIZE);
+    cart->mirroring = Mirroring::vertical;
+
+    size_t i = 0;
+    while(i < cart->prgRom.size())
+    {
+        U8 op = opCodes[random() % opCodes.size()];
+        U8 length = RP2A03::getLength(op);
+
+        cart->prgRom[i++] = op;
+        if(length >= 2 && i < cart->prgRom.size())
+        {
+            cart->prgRom[i++] = randomByte();
+        }
+        if(length >= 3 && i < cart->prgRom.size())
+        {
+            cart->prgRom[i++] = randomAddressHigh();
+        }
+    }
+
+    return cart;
+}
+
+
+/**
+ * @brief Random registers and internal RAM
+ *
+ */
+void InstructionFuzzer::randomizeConsole(NES& console)
+{
+    U16 pc = static_cast<U16>(random());
+    console.getCPU()->setRegisters(pc, randomByte(), randomByte(), randomByte(), randomByte(), randomByte() | Flags::UNUSED_FLAG);
+
+    U8* ram = console.getRAM();
+    for(U16 addr = 0; addr < LOCKSTEP_RAM_SIZE; addr++)
+    {
+        ram[addr] = randomByte();
+    }
+}
+
+
+/**
+ * @brief Runs both engines on a fresh random program and random lane states
+ *
+ * @param divergence Receives the report on a mismatch (may be nullptr)
+ *
+ * @return false if the engines diverged
+ */
+bool InstructionFuzzer::fuzz(U32 lanes, U64 instructions, CPUDivergence* divergence)
+{
+    LockstepValidator validator(generateCartridge(), lanes);
+
+    for(U32 lane = 0; lane < validator.getLaneCount(); lane++)
+    {
+        randomizeConsole(*validator.getReference(lane));
+    }
+    validator.syncLanes();
+
+    // Mismatching blocks are replayed, so the report still names the exact instruction
+    bool matched = validator.run(instructions, VALIDATOR_FUZZ_BLOCK);
+    if(!matched && divergence)
+    {
+        *divergence = validator.getDivergence();
+    }
+
+    return matched;
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "../inc/framepacer.h"
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+
+/**
+ * @brief Hint to the CPU that this is a spin-wait loop
+ *
+ */
+static inline void spinPause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+
+/**
+ * @brief Whole microseconds in a duration (negative durations count as zero)
+ *
+ */
+template <typename Duration>
+static U64 toMicroseconds(Duration duration)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return (us > 0) ? static_cast<U64>(us) : 0;
+}
+
+
+/**
+ * @brief Empties the histogram
+ *
+ */
+void LatencyHistogram::clear(void)
+{
+    bins.fill(0);
+    overflow = 0;
+    count = 0;
+    totalUs = 0;
+    maxUs = 0;
+}
+
+
+/**
+ * @brief Adds one sample
+ *
+ */
+void LatencyHistogram::record(U64 us)
+{
+    U64 bin = us / PACER_HISTOGRAM_BIN_US;
+
+    if(bin < PACER_HISTOGRAM_BINS)
+    {
+        bins[bin]++;
+    }
+    else
+    {
+        overflow++;
+    }
+
+    count++;
+    totalUs += us;
+    maxUs = (us > maxUs) ? us : maxUs;
+}
+
+
+/**
+ * @brief Upper edge of the bin holding the p-th percentile
+ *
+ * @param p Percentile as a fraction (0.99 for the 99th)
+ *
+ * @return Microseconds, or maxUs if the percentile falls in the overflow bin
+ */
+U64 LatencyHistogram::percentile(double p) const
+{
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    U64 rank = static_cast<U64>(p * (count - 1)) + 1;
+    U64 seen = 0;
+
+    for(U32 bin = 0; bin < PACER_HISTOGRAM_BINS; bin++)
+    {
+        seen += bins[bin];
+        if(seen >= rank)
+        {
+            return (U64)(bin + 1) * PACER_HISTOGRAM_BIN_US;
+        }
+    }
+
+    return maxUs;
+}
+
+
+FramePacer::FramePacer(VideoStandard standard)
+{
+    started = false;
+    spinUs = PACER_MIN_SPIN_US;
+    sleepOvershootUs = 0;
+
+    // The first frame's emulation time counts from here
+    lastWake = Clock::now();
+
+    resetMetrics();
+    setStandard(standard);
+}
+
+FramePacer::~FramePacer(){}
+
+
+/**
+ * @brief Sets the nominal refresh rate
+ *
+ */
+void FramePacer::setRefreshRate(double hz)
+{
+    nominalHz = hz;
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+
+/**
+ * @brief Paces to the NTSC or PAL refresh rate
+ *
+ */
+void FramePacer::setStandard(VideoStandard standard)
+{
+    setRefreshRate((standard == VideoStandard::PAL) ? PACER_PAL_HZ : PACER_NTSC_HZ);
+}
+
+
+/**
+ * @brief Sleeps until shortly before the target, then spins until it
+ *
+ * @details The spin margin tracks twice the moving average of the sleep's
+ * overshoot, clamped to [PACER_MIN_SPIN_US, PACER_MAX_SPIN_US].
+ *
+ * @param overshootUs How far the OS sleep woke up past its target
+ *
+ * @return false if the target was already within the spin margin (no sleep)
+ */
+bool FramePacer::sleepUntil(Clock::time_point target, U64* overshootUs)
+{
+    Clock::time_point spinFrom = target - std::chrono::microseconds(spinUs);
+    bool slept = Clock::now() < spinFrom;
+
+    if(slept)
+    {
+        std::this_thread::sleep_until(spinFrom);
+
+        *overshootUs = toMicroseconds(Clock::now() - spinFrom);
+        sleepOvershootUs = (sleepOvershootUs * 7 + *overshootUs) / 8;
+
+        U64 margin = sleepOvershootUs * 2;
+        spinUs = (margin < PACER_MIN_SPIN_US) ? PACER_MIN_SPIN_US : (margin > PACER_MAX_SPIN_US) ? PACER_MAX_SPIN_US : margin;
+    }
+
+    while(Clock::now() < target)
+    {
+        spinPause();
+    }
+
+    return slept;
+}
+
+
+/**
+ * @brief Waits until the next frame is due and records the frame's metrics
+ *
+ * @details Deadlines advance by whole periods. A late frame isn't waited for and
+ * the next deadline stays on the grid, so the pacer catches up. After falling
+ * more than PACER_MAX_LAG_FRAMES behind (a pause, a debugger stop) the grid
+ * restarts from now instead of fast-forwarding. The first frame of a grid
+ * starts it one period from now and has no interval to measure jitter on.
+ */
+void FramePacer::waitForNextFrame(void)
+{
+    Clock::time_point now = Clock::now();
+    U64 emulationUs = toMicroseconds(now - lastWake);
+    bool first = !started;
+
+    if(first)
+    {
+        started = true;
+        deadline = now + period;
+    }
+
+    bool late = now > deadline;
+    bool resync = late && (now - deadline) > period * PACER_MAX_LAG_FRAMES;
+    bool slept = false;
+    U64 overshootUs = 0;
+
+    if(resync)
+    {
+        deadline = now;
+    }
+    else if(!late)
+    {
+        slept = sleepUntil(deadline, &overshootUs);
+    }
+
+    Clock::time_point wake = Clock::now();
+    U64 intervalUs = toMicroseconds(wake - lastWake);
+    U64 periodUs = toMicroseconds(period);
+    U64 jitterUs = (intervalUs > periodUs) ? intervalUs - periodUs : periodUs - intervalUs;
+
+    lastWake = wake;
+    deadline += period;
+
+    std::lock_guard<std::mutex> lock(metricsLock);
+    metrics.frames++;
+    metrics.lateFrames += late;
+    metrics.resyncs += resync;
+    metrics.emulation.record(emulationUs);
+
+    if(slept)
+    {
+        metrics.overshoot.record(overshootUs);
+    }
+
+    if(!first)
+    {
+        metrics.jitter.record(jitterUs);
+    }
+}
+
+
+/**
+ * @brief Starts a new deadline grid at the next waitForNextFrame()
+ *
+ */
+void FramePacer::restart(void)
+{
+    started = false;
+    lastWake = Clock::now();
+}
+
+
+/**
+ * @brief Copy of the metrics (safe to call from another thread)
+ *
+ */
+PacerMetrics FramePacer::getMetrics(void) const
+{
+    std::lock_guard<std::mutex> lock(metricsLock);
+    return metrics;
+}
+
+
+/**
+ * @brief Clears the counters and histograms
+ *
+ */
+void FramePacer::resetMetrics(void)
+{
+    std::lock_guard<std::mutex> lock(metricsLock);
+    metrics.frames = 0;
+    metrics.lateFrames = 0;
+    metrics.resyncs = 0;
+    metrics.emulation.clear();
+    metrics.overshoot.clear();
+    metrics.jitter.clear();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "../inc/instancearena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define ARENA_MMAP_SUPPORTED
+#endif
+
+
+/**
+ * @brief Maps one arena chunk
+ *
+ * @details Tries reserved hugepages (MAP_HUGETLB) first. Without them, maps a
+ * hugepage aligned region, asks for transparent hugepages and faults it in. Platforms
+ * without mmap get an aligned heap block.
+ *
+ * @return The chunk, or nullptr if no memory could be mapped
+ */
+void* mapArenaChunk(void)
+{
+#ifdef ARENA_MMAP_SUPPORTED
+#ifdef MAP_HUGETLB
+    void* chunk = mmap(nullptr, ARENA_CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if(chunk != MAP_FAILED)
+    {
+        return chunk;
+    }
+#endif
+
+    // Over-map so the chunk can start on a hugepage boundary, then trim both ends
+    void* mapping = mmap(nullptr, ARENA_CHUNK_SIZE * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mapping == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    U8* region = static_cast<U8*>(mapping);
+    U8* start = reinterpret_cast<U8*>((reinterpret_cast<uintptr_t>(region) + ARENA_CHUNK_SIZE - 1) & ~(uintptr_t)(ARENA_CHUNK_SIZE - 1));
+    size_t head = start - region;
+
+    if(head)
+    {
+        munmap(region, head);
+    }
+    munmap(start + ARENA_CHUNK_SIZE, ARENA_CHUNK_SIZE - head);
+
+#ifdef MADV_HUGEPAGE
+    madvise(start, ARENA_CHUNK_SIZE, MADV_HUGEPAGE);
+#endif
+
+    // Fault the chunk in now rather than on the first clone into each slot
+    std::memset(start, 0, ARENA_CHUNK_SIZE);
+
+    return start;
+#else
+    return ::operator new(ARENA_CHUNK_SIZE, std::align_val_t(ARENA_CHUNK_SIZE), std::nothrow);
+#endif
+}
\ No newline at end of file
@@ -1,16 +1,209 @@
-#include "../inc/main.h"
-
-
-int main(int argc, char* argv[])
-{
-    (void)argc; (void)argv;
-
-    RP2A03 cpu;
-
-    cpu.reset();
-
-    while(1)
-    {
-        cpu.CPU_Cycle();
-    }
+#include "../inc/main.h"
+
+
+/* Cleared by SIGINT/SIGTERM so the frame loop can report before exiting */
+static volatile std::sig_atomic_t running = 1;
+
+static void stopRunning(int)
+{
+    running = 0;
+}
+
+
+/**
+ * @brief Prints the pacer's frame timing (median and 99th percentile) to stderr
+ *
+ */
+static void printPacerMetrics(const PacerMetrics& metrics)
+{
+    std::fprintf(stderr, "frames %llu, late %llu, resyncs %llu\n",
+                 (unsigned long long)metrics.frames, (unsigned long long)metrics.lateFrames, (unsigned long long)metrics.resyncs);
+    std::fprintf(stderr, "emulation  p50 %llu us, p99 %llu us\n",
+                 (unsigned long long)metrics.emulation.percentile(0.50), (unsigned long long)metrics.emulation.percentile(0.99));
+    std::fprintf(stderr, "overshoot  p50 %llu us, p99 %llu us\n",
+                 (unsigned long long)metrics.overshoot.percentile(0.50), (unsigned long long)metrics.overshoot.percentile(0.99));
+    std::fprintf(stderr, "jitter     p50 %llu us, p99 %llu us\n",
+                 (unsigned long long)metrics.jitter.percentile(0.50), (unsigned long long)metrics.jitter.percentile(0.99));
+}
+
+
+/**
+ * @brief Instructions per second of one engine over a run
+ *
+ */
+template <typename Step>
+static double measureRate(U64 steps, U64 instructionsPerStep, Step step)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(U64 i = 0; i < steps; i++)
+    {
+        step();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (steps * instructionsPerStep) / elapsed.count();
+}
+
+
+/**
+ * @brief Runs LOCKSTEP_LANES scalar CPUs and the lockstep engine (every kernel
+ * instruction set the host has) on the same random program and prints their
+ * throughput
+ *
+ * @details Lanes either share one state, so every step is one opcode group, or
+ * start from random states, so they diverge into per-lane groups.
+ */
+static void benchmarkLockstep(U64 seed, U64 instructions)
+{
+    const char* names[3] = {"avx512", "avx2", "portable"};
+
+    InstructionFuzzer fuzzer(seed);
+    std::shared_ptr<const Cartridge> cartridge = fuzzer.generateCartridge();
+
+    std::printf("%u lanes, %llu instructions per lane\n", LOCKSTEP_LANES, (unsigned long long)instructions);
+
+    for(U32 shared = 0; shared < 2; shared++)
+    {
+        std::vector<InstanceArena<NES>::Pointer> consoles;
+        for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+        {
+            consoles.push_back(InstanceArena<NES>::instance().create());
+            consoles.back()->insertCartridge(cartridge);
+
+            if(lane == 0 || !shared)
+            {
+                fuzzer.randomizeConsole(*consoles.back());
+            }
+            else
+            {
+                RP2A03* cpu = consoles[0]->getCPU();
+                consoles.back()->getCPU()->setRegisters(cpu->getPC(), cpu->getSP(), cpu->getA(), cpu->getX(), cpu->getY(), cpu->getStatus());
+                std::copy(consoles[0]->getRAM(), consoles[0]->getRAM() + LOCKSTEP_RAM_SIZE, consoles.back()->getRAM());
+            }
+        }
+
+        // Every engine starts from the same lane states
+        std::vector<InstanceArena<NES>::Pointer> scalar;
+        for(auto& console : consoles)
+        {
+            scalar.push_back(console->clone());
+        }
+
+        double scalarRate = measureRate(instructions, LOCKSTEP_LANES, [&]
+        {
+            for(auto& console : scalar)
+            {
+                console->getCPU()->CPU_Cycle();
+            }
+        });
+
+        std::printf("%-8s  scalar    %8.1f M instr/s\n", shared ? "shared" : "diverged", scalarRate / 1e6);
+
+        for(U8 isa = 0; isa < 3; isa++)
+        {
+            RP2A03Lockstep lockstep;
+            lockstep.insertCartridge(cartridge);
+            lockstep.setISA(static_cast<LockstepISA>(isa));
+            if(lockstep.getISA() != static_cast<LockstepISA>(isa))
+            {
+                continue;
+            }
+
+            std::vector<InstanceArena<NES>::Pointer> devices;
+            for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+            {
+                devices.push_back(consoles[lane]->clone());
+                lockstep.loadLane(lane, *consoles[lane]->getCPU(), consoles[lane]->getRAM());
+                lockstep.attachBus(lane, devices[lane]->getBus());
+            }
+
+            double rate = measureRate(instructions, LOCKSTEP_LANES, [&]
+            {
+                lockstep.step();
+            });
+
+            std::printf("%-8s  %-8s  %8.1f M instr/s  (%.2fx)\n", "", names[isa], rate / 1e6, rate / scalarRate);
+        }
+    }
+}
+
+
+/**
+ * @brief Parses a numeric command line argument
+ *
+ * @return false if the argument isn't a number
+ */
+static bool parseNumber(const char* text, U64* value)
+{
+    try
+    {
+        size_t used = 0;
+        *value = std::stoull(text, &used);
+        return text[used] == '\0';
+    }
+    catch(const std::exception&)
+    {
+        return false;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    // nesEmu --bench [instructions]: lockstep engine against scalar CPUs
+    if(argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        U64 instructions = BENCH_INSTRUCTIONS;
+        if(argc > 2 && !parseNumber(argv[2], &instructions))
+        {
+            std::fputs("usage: nesEmu --bench [instructions]\n", stderr);
+            return 1;
+        }
+
+        benchmarkLockstep(1, instructions);
+        return 0;
+    }
+
+    // nesEmu --fuzz [seed]: differential run of the CPU engines on a random program
+    if(argc > 1 && std::string(argv[1]) == "--fuzz")
+    {
+        U64 seed = 1;
+        if(argc > 2 && !parseNumber(argv[2], &seed))
+        {
+            std::fputs("usage: nesEmu --fuzz [seed]\n", stderr);
+            return 1;
+        }
+
+        CPUDivergence divergence;
+
+        if(!InstructionFuzzer(seed).fuzz(LOCKSTEP_LANES, VALIDATOR_FUZZ_INSTRUCTIONS, &divergence))
+        {
+            std::fputs(divergence.report().c_str(), stderr);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    NES nes;
+
+    if(argc > 1 && !nes.loadROM(std::string(argv[1])))
+    {
+        return 1;
+    }
+
+    // Paced to the NTSC refresh rate instead of running flat out
+    FramePacer pacer(VideoStandard::NTSC);
+
+    std::signal(SIGINT, stopRunning);
+    std::signal(SIGTERM, stopRunning);
+
+    while(running)
+    {
+        nes.stepFrame();
+        pacer.waitForNextFrame();
+    }
+
+    printPacerMetrics(pacer.getMetrics());
+    return 0;
 }
\ No newline at end of file
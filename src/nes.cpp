@@ -0,0 +1,278 @@
+#include "../inc/nes.h"
+
+
+NES::NES()
+{
+    cpu.connectBus(&bus);
+    bus.connectCPU(&cpu);
+    reset();
+
+    stateBytes = saveState(nullptr, 0);
+}
+
+NES::NES(const NES& other) : bus(other.bus), cpu(other.cpu), stateBytes(other.stateBytes)
+{
+    cpu.connectBus(&bus);
+    bus.connectCPU(&cpu);
+}
+
+NES::~NES(){}
+
+
+/**
+ * @brief Duplicates the console into an arena slot
+ *
+ */
+InstanceArena<NES>::Pointer NES::clone(void) const
+{
+    return InstanceArena<NES>::instance().create(*this);
+}
+
+
+/**
+ * @brief Reserves arena slots for the console, its memory and its PPU
+ *
+ * @return false if the arenas couldn't be mapped
+ */
+bool NES::reserveInstances(size_t count)
+{
+    return InstanceArena<NES>::instance().reserve(count) &&
+           InstanceArena<NESMemory>::instance().reserve(count) &&
+           InstanceArena<RP2C02>::instance().reserve(count);
+}
+
+
+/**
+ * @brief Loads an iNES image from memory and resets the console
+ *
+ * @return false if the image is malformed or uses an unsupported mapper
+ */
+bool NES::loadROM(const U8* data, size_t size)
+{
+    std::shared_ptr<const Cartridge> cart = loadINES(data, size);
+    if(!cart)
+    {
+        return false;
+    }
+
+    insertCartridge(std::move(cart));
+    return true;
+}
+
+
+/**
+ * @brief Loads an iNES file and resets the console
+ *
+ * @return false if the file can't be read, is malformed or uses an unsupported mapper
+ */
+bool NES::loadROM(const std::string& path)
+{
+    std::shared_ptr<const Cartridge> cart = loadINESFile(path);
+    if(!cart)
+    {
+        return false;
+    }
+
+    insertCartridge(std::move(cart));
+    return true;
+}
+
+
+/**
+ * @brief Inserts an already loaded cartridge (shared with other consoles) and resets
+ *
+ */
+void NES::insertCartridge(std::shared_ptr<const Cartridge> cart)
+{
+    bus.insertCartridge(std::move(cart));
+    reset();
+
+    stateBytes = saveState(nullptr, 0);
+}
+
+
+/**
+ * @brief Resets the CPU, the PPU and the APU
+ *
+ */
+void NES::reset(void)
+{
+    bus.reset();
+    cpu.reset();
+}
+
+
+/**
+ * @brief Executes one CPU instruction, including any OAM DMA it triggers
+ *
+ */
+void NES::executeInstruction(void)
+{
+    cpu.CPU_Cycle();
+
+    // OAM DMA halts the CPU while the PPU keeps running. The halt is CPU time,
+    // not a device event, so it is added to the cycle count instead of being
+    // scheduled; events that fall due during it run once the CPU resumes
+    cpu.stall(bus.takeDMAStall(cpu.getCycles()));
+}
+
+
+/**
+ * @brief Whether the CPU would take an interrupt before its next instruction
+ *
+ */
+bool NES::isInterruptReady(void)
+{
+    return bus.isNMIPending() || (bus.isIRQAsserted() && !(cpu.getStatus() & Flags::INTERRUPT_DISABLE_FLAG));
+}
+
+
+/**
+ * @brief Enters the NMI or IRQ handler if one is pending
+ *
+ * @return true if the CPU took an interrupt
+ */
+bool NES::serviceInterrupts(void)
+{
+    if(bus.takeNMI())
+    {
+        cpu.NMI();
+        return true;
+    }
+
+    if(bus.isIRQAsserted() && !(cpu.getStatus() & Flags::INTERRUPT_DISABLE_FLAG))
+    {
+        cpu.IRQ();
+        return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Takes a pending interrupt or executes one CPU instruction, then
+ * catches the PPU up with it
+ *
+ */
+void NES::stepInstruction(void)
+{
+    if(!serviceInterrupts())
+    {
+        executeInstruction();
+    }
+
+    bus.runEvents();
+    bus.syncPPU();
+}
+
+
+/**
+ * @brief Runs until the PPU reaches the next vblank
+ *
+ * @details The CPU runs freely up to the next scheduled event (vblank, APU or
+ * cartridge IRQ); the PPU only catches up when a register access or an event
+ * needs it.
+ */
+void NES::stepFrame(void)
+{
+    U64 frame = bus.getPPU()->getFrameCount();
+
+    while(bus.getPPU()->getFrameCount() == frame)
+    {
+        // Re-read every instruction: a register write can schedule an earlier event
+        while(cpu.getCycles() < bus.getNextEventCycle() && !isInterruptReady())
+        {
+            executeInstruction();
+        }
+
+        bus.runEvents();
+        serviceInterrupts();
+    }
+
+    bus.syncPPU();
+
+    if(publisher)
+    {
+        publisher->publish(cpu, *bus.getMemory(), *bus.getPPU());
+    }
+}
+
+
+/**
+ * @brief Publishes a snapshot into a POSIX shared memory segment after every frame
+ *
+ * @param segmentName Segment name (e.g. "/nes0"), or empty to stop publishing
+ *
+ * @return false if the segment couldn't be created
+ */
+bool NES::publishState(const std::string& segmentName)
+{
+    publisher.reset();
+
+    if(segmentName.empty())
+    {
+        return true;
+    }
+
+    publisher = std::make_unique<StatePublisher>(segmentName);
+    if(!publisher->isOpen())
+    {
+        publisher.reset();
+        return false;
+    }
+
+    publisher->publish(cpu, *bus.getMemory(), *bus.getPPU());
+    return true;
+}
+
+
+/**
+ * @brief Serializes the console into a caller-provided buffer
+ *
+ * @param buffer Destination, or nullptr to only compute the size
+ * @param size Size of the destination in bytes
+ *
+ * @return Size of the state in bytes (larger than size if it didn't fit)
+ */
+size_t NES::saveState(U8* buffer, size_t size)
+{
+    StateWriter state(buffer, size);
+
+    state.put(SAVESTATE_MAGIC);
+    state.put(SAVESTATE_VERSION);
+    cpu.saveState(state);
+    bus.saveState(state);
+
+    return state.size();
+}
+
+
+/**
+ * @brief Restores the console from a save state
+ *
+ * @return false if the buffer doesn't hold a state for this console and cartridge
+ */
+bool NES::loadState(const U8* buffer, size_t size)
+{
+    if(!buffer || size != stateSize())
+    {
+        return false;
+    }
+
+    StateReader state(buffer, size);
+
+    U32 magic = 0;
+    U32 version = 0;
+    state.get(magic);
+    state.get(version);
+    if(magic != SAVESTATE_MAGIC || version != SAVESTATE_VERSION)
+    {
+        return false;
+    }
+
+    cpu.loadState(state);
+    bus.loadState(state);
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "../inc/nesemu.h"
+#include "../inc/instancearena.h"
+#include "../inc/nes.h"
+#include "../inc/palette.h"
+#include "../inc/statetracker.h"
+
+#include <new>
+
+
+/* The handle is the console and its state tracker */
+struct nes_t
+{
+    NES console;
+    StateTracker tracker{console};
+
+    nes_t() {}
+    nes_t(const nes_t& other) : console(other.console), tracker(console) {}
+};
+
+
+/**
+ * @brief Runs an entry point's body; exceptions must not cross the C boundary
+ *
+ * @param onError Returned if the body throws
+ */
+template<typename R, typename F>
+static R guarded(R onError, F&& body)
+{
+    try
+    {
+        return body();
+    }
+    catch(...)
+    {
+        return onError;
+    }
+}
+
+
+/**
+ * @brief guarded() for entry points without a result
+ *
+ */
+template<typename F>
+static void guarded(F&& body)
+{
+    try
+    {
+        body();
+    }
+    catch(...)
+    {
+    }
+}
+
+
+nes_t* nes_create(void)
+{
+    return guarded<nes_t*>(nullptr, []
+    {
+        return InstanceArena<nes_t>::instance().create().release();
+    });
+}
+
+void nes_destroy(nes_t* nes)
+{
+    guarded([&]
+    {
+        InstanceArena<nes_t>::instance().destroy(nes);
+    });
+}
+
+nes_t* nes_clone(nes_t* nes)
+{
+    // Same pooled path as NES::clone(): handle, memory and PPU all come from arenas
+    return guarded<nes_t*>(nullptr, [&]
+    {
+        return InstanceArena<nes_t>::instance().create(*nes).release();
+    });
+}
+
+int nes_reserve(size_t count)
+{
+    return guarded(-1, [&]
+    {
+        return (InstanceArena<nes_t>::instance().reserve(count) &&
+                InstanceArena<NESMemory>::instance().reserve(count) &&
+                InstanceArena<RP2C02>::instance().reserve(count)) ? 0 : -1;
+    });
+}
+
+int nes_load_rom(nes_t* nes, const uint8_t* data, size_t size)
+{
+    return guarded(-1, [&]
+    {
+        return nes->console.loadROM(data, size) ? 0 : -1;
+    });
+}
+
+int nes_load_rom_file(nes_t* nes, const char* path)
+{
+    if(!path)
+    {
+        return -1;
+    }
+
+    return guarded(-1, [&]
+    {
+        return nes->console.loadROM(std::string(path)) ? 0 : -1;
+    });
+}
+
+void nes_reset(nes_t* nes)
+{
+    guarded([&]
+    {
+        nes->console.reset();
+    });
+}
+
+void nes_step_frame(nes_t* nes)
+{
+    guarded([&]
+    {
+        nes->console.stepFrame();
+    });
+}
+
+void nes_step_frames(nes_t* nes, uint32_t count)
+{
+    guarded([&]
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            nes->console.stepFrame();
+        }
+    });
+}
+
+uint64_t nes_frame_count(nes_t* nes)
+{
+    return guarded<uint64_t>(0, [&]
+    {
+        return nes->console.getPPU()->getFrameCount();
+    });
+}
+
+void nes_set_input(nes_t* nes, int port, uint8_t buttons)
+{
+    guarded([&]
+    {
+        nes->console.setInput(static_cast<U8>(port), buttons);
+    });
+}
+
+size_t nes_state_size(nes_t* nes)
+{
+    return guarded<size_t>(0, [&]
+    {
+        return nes->console.stateSize();
+    });
+}
+
+int nes_save_state(nes_t* nes, void* buffer, size_t size)
+{
+    if(!buffer)
+    {
+        return -1;
+    }
+
+    return guarded(-1, [&]
+    {
+        return (nes->console.saveState(static_cast<U8*>(buffer), size) <= size) ? 0 : -1;
+    });
+}
+
+int nes_load_state(nes_t* nes, const void* buffer, size_t size)
+{
+    return guarded(-1, [&]
+    {
+        return nes->console.loadState(static_cast<const U8*>(buffer), size) ? 0 : -1;
+    });
+}
+
+uint64_t nes_state_hash(nes_t* nes)
+{
+    return guarded<uint64_t>(0, [&]
+    {
+        return nes->tracker.hash();
+    });
+}
+
+size_t nes_save_delta(nes_t* nes, void* buffer, size_t size)
+{
+    return guarded<size_t>(0, [&]
+    {
+        return nes->tracker.saveDelta(static_cast<U8*>(buffer), size);
+    });
+}
+
+int nes_load_delta(nes_t* nes, const void* buffer, size_t size)
+{
+    return guarded(-1, [&]
+    {
+        return nes->tracker.loadDelta(static_cast<const U8*>(buffer), size) ? 0 : -1;
+    });
+}
+
+void nes_mark_dirty(nes_t* nes)
+{
+    guarded([&]
+    {
+        nes->console.getBus()->markAllDirty();
+    });
+}
+
+const uint8_t* nes_framebuffer(nes_t* nes)
+{
+    return guarded<const uint8_t*>(nullptr, [&]
+    {
+        return nes->console.getFrameBuffer();
+    });
+}
+
+uint8_t* nes_ram(nes_t* nes)
+{
+    return guarded<uint8_t*>(nullptr, [&]
+    {
+        return nes->console.getRAM();
+    });
+}
+
+int nes_convert_frame(nes_t* nes, void* pixels, size_t pitch, int format)
+{
+    return guarded(-1, [&]
+    {
+        const U8* frameBuffer = nes->console.getFrameBuffer();
+        if(!frameBuffer || format < NESEMU_FORMAT_RGBA8888 || format > NESEMU_FORMAT_RGB565)
+        {
+            return -1;
+        }
+
+        PaletteConverter::instance().convertFrame(frameBuffer, pixels, pitch, static_cast<PixelFormat>(format));
+        return 0;
+    });
+}
+
+int nes_publish_shm(nes_t* nes, const char* name)
+{
+    return guarded(-1, [&]
+    {
+        return nes->console.publishState(name ? std::string(name) : std::string()) ? 0 : -1;
+    });
+}
+
+int nes_set_render_interval(nes_t* nes, uint32_t interval)
+{
+    // The PPU counts frames in 16 bits; a wider interval must not wrap to 0 (never)
+    if(interval > UINT16_MAX)
+    {
+        return -1;
+    }
+
+    return guarded(-1, [&]
+    {
+        nes->console.getPPU()->setRenderInterval(static_cast<U16>(interval));
+        return 0;
+    });
+}
\ No newline at end of file
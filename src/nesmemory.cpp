@@ -1,4 +1,152 @@
-#include "../inc/nesmemory.h"
-
-NESMemory::NESMemory(){}
-NESMemory::~NESMemory(){}
\ No newline at end of file
+#include "../inc/nesmemory.h"
+
+NESMemory::NESMemory()
+{
+    ram.ram.fill(0);
+    io.io_registers2.fill(0);
+    sram.sram.fill(0);
+}
+
+NESMemory::~NESMemory(){}
+
+
+/**
+ * @brief Reads a byte from CPU memory (everything except the PPU registers)
+ *
+ * @param addr CPU address
+ *
+ * @return Value at the address, 0 for unmapped addresses
+ */
+U8 NESMemory::read(U16 addr)
+{
+    if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+    {
+        // 0x0800 - 0x1FFF mirror the 2 KB of internal RAM
+        return ram.ram[addr & 0x07FF];
+    }
+    else if(addr >= MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR && addr < MemoryMap::MEM_ROM_EXP_BASE_ADDR)
+    {
+        return io.io_registers2[addr - MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR];
+    }
+    else if(addr >= MemoryMap::MEM_SRAM_BASE_ADDR && addr < MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR)
+    {
+        return sram.sram[addr - MemoryMap::MEM_SRAM_BASE_ADDR];
+    }
+    else if(addr >= MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR && cartridge && !cartridge->prgRom.empty())
+    {
+        // 16 KB images are mirrored into 0xC000 - 0xFFFF
+        return cartridge->prgRom[(addr - MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR) % cartridge->prgRom.size()];
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Writes a byte to CPU memory (everything except the PPU registers)
+ *
+ * @details Writes to ROM and unmapped addresses are ignored.
+ *
+ * @param addr CPU address
+ * @param data Value to write
+ */
+void NESMemory::write(U16 addr, U8 data)
+{
+    if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+    {
+        ram.ram[addr & 0x07FF] = data;
+    }
+    else if(addr >= MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR && addr < MemoryMap::MEM_ROM_EXP_BASE_ADDR)
+    {
+        io.io_registers2[addr - MemoryMap::MEM_IO_REGISTER_2_BASE_ADDR] = data;
+    }
+    else if(addr >= MemoryMap::MEM_SRAM_BASE_ADDR && addr < MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR)
+    {
+        sram.sram[addr - MemoryMap::MEM_SRAM_BASE_ADDR] = data;
+    }
+}
+
+
+/**
+ * @brief Resolves a CPU page to its backing memory for bulk reads (OAM DMA)
+ *
+ * @details Follows the same decoding as read(). RAM, SRAM and PRG ROM pages are
+ * contiguous in their storage; I/O pages have per-address side effects.
+ *
+ * @param page High byte of the CPU address
+ *
+ * @return The page's 256 bytes, or nullptr if the page has to be read byte by byte
+ */
+const U8* NESMemory::getPage(U8 page)
+{
+    U16 addr = page << 8;
+
+    if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+    {
+        return &ram.ram[addr & 0x07FF];
+    }
+    else if(addr >= MemoryMap::MEM_SRAM_BASE_ADDR && addr < MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR)
+    {
+        return &sram.sram[addr - MemoryMap::MEM_SRAM_BASE_ADDR];
+    }
+    else if(addr >= MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR && cartridge && !cartridge->prgRom.empty())
+    {
+        return &cartridge->prgRom[(addr - MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR) % cartridge->prgRom.size()];
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * @brief Maps a cartridge's PRG ROM into 0x8000 - 0xFFFF
+ *
+ */
+void NESMemory::insertCartridge(std::shared_ptr<const Cartridge> cart)
+{
+    cartridge = std::move(cart);
+}
+
+
+/**
+ * @brief Serializes RAM, I/O registers and SRAM
+ *
+ */
+void NESMemory::saveState(StateWriter& state)
+{
+    state.put(ram);
+    state.put(io);
+    state.put(sram);
+}
+
+
+/**
+ * @brief Restores RAM, I/O registers and SRAM
+ *
+ */
+void NESMemory::loadState(StateReader& state)
+{
+    state.get(ram);
+    state.get(io);
+    state.get(sram);
+}
+
+
+/**
+ * @brief Serializes everything except the paged memory (RAM, SRAM)
+ *
+ */
+void NESMemory::saveRegisters(StateWriter& state)
+{
+    state.put(io);
+}
+
+
+/**
+ * @brief Restores everything except the paged memory (RAM, SRAM)
+ *
+ */
+void NESMemory::loadRegisters(StateReader& state)
+{
+    state.get(io);
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "../inc/netplay.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+RollbackSession::RollbackSession(NES& nes, Transport& link, U8 port, U32 rollbackFrames) :
+    console(nes), transport(link), localPort(port & 0x01)
+{
+    maxRollback = std::min(std::max(rollbackFrames, (U32)1), NETPLAY_MAX_ROLLBACK);
+
+    frame = 0;
+    remoteConfirmed = 0;
+    peerAck = 0;
+    rollbackFrom = NETPLAY_NO_ROLLBACK;
+    resimulateTo = 0;
+    catchUpLimit = maxRollback;
+
+    localInputs.assign(NETPLAY_HISTORY, 0);
+    remoteInputs.assign(NETPLAY_HISTORY, 0);
+    usedInputs.assign(NETPLAY_HISTORY, 0);
+
+    // Allocated once; rollbacks only copy into them
+    snapshots.assign(maxRollback + 1, std::vector<U8>(console.stateSize()));
+
+    stats = RollbackStats();
+}
+
+RollbackSession::~RollbackSession(){}
+
+
+/**
+ * @brief Runs the next frame, rolling back first if a misprediction came in
+ *
+ * @param localButtons Buttons of the local player for this frame
+ *
+ * @return false if the console is maxRollback frames ahead of the remote and has
+ * to wait, or is still re-simulating a rollback deeper than the catch-up limit
+ * (the same buttons should be passed again)
+ */
+bool RollbackSession::advanceFrame(U8 localButtons)
+{
+    receiveInputs();
+
+    if(rollbackFrom != NETPLAY_NO_ROLLBACK)
+    {
+        rollback();
+    }
+
+    if(frame < resimulateTo)
+    {
+        resimulate();
+
+        if(frame < resimulateTo)
+        {
+            stats.catchUps++;
+            sendInputs();
+            return false;
+        }
+    }
+
+    if(frame + 1 > remoteConfirmed + maxRollback)
+    {
+        // Keep resending so the peer can catch up
+        stats.stalls++;
+        sendInputs();
+        return false;
+    }
+
+    localInputs[frame % NETPLAY_HISTORY] = localButtons;
+    runFrame((frame < remoteConfirmed) ? remoteInputs[frame % NETPLAY_HISTORY] : predictRemote());
+    stats.frames++;
+
+    sendInputs();
+    return true;
+}
+
+
+/**
+ * @brief Saves the snapshot of the next frame and runs it with the given remote input
+ *
+ */
+void RollbackSession::runFrame(U8 remoteButtons)
+{
+    std::vector<U8>& snapshot = snapshots[frame % (maxRollback + 1)];
+    console.saveState(snapshot.data(), snapshot.size());
+
+    usedInputs[frame % NETPLAY_HISTORY] = remoteButtons;
+    console.setInput(localPort, localInputs[frame % NETPLAY_HISTORY]);
+    console.setInput(localPort ^ 0x01, remoteButtons);
+    console.stepFrame();
+
+    frame++;
+}
+
+
+/**
+ * @brief Restores the earliest mispredicted frame; resimulate() runs the frames since
+ *
+ */
+void RollbackSession::rollback(void)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // A rollback during catch-up still has to reach the frame the console was at
+    resimulateTo = std::max(resimulateTo, frame);
+    frame = rollbackFrom;
+    rollbackFrom = NETPLAY_NO_ROLLBACK;
+
+    const std::vector<U8>& snapshot = snapshots[frame % (maxRollback + 1)];
+    console.loadState(snapshot.data(), snapshot.size());
+
+    U32 depth = resimulateTo - frame;
+    stats.rollbacks++;
+    stats.resimulatedFrames += depth;
+    stats.deepestRollback = std::max(stats.deepestRollback, depth);
+    stats.lastRollbackUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ * @brief Re-simulates up to catchUpLimit frames towards the frame before the rollback
+ *
+ * @details Re-simulated frames are never shown, so pixel output is suppressed for
+ * them; the frame buffer keeps the last frame that was.
+ */
+void RollbackSession::resimulate(void)
+{
+    auto start = std::chrono::steady_clock::now();
+    U32 target = std::min(resimulateTo, frame + catchUpLimit);
+
+    bool suppressed = console.getPPU()->isOutputSuppressed();
+    console.getPPU()->setOutputSuppressed(true);
+
+    while(frame < target)
+    {
+        runFrame((frame < remoteConfirmed) ? remoteInputs[frame % NETPLAY_HISTORY] : predictRemote());
+    }
+
+    console.getPPU()->setOutputSuppressed(suppressed);
+
+    stats.lastRollbackUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ * @brief Predicts the remote input as the last one received
+ *
+ */
+U8 RollbackSession::predictRemote(void)
+{
+    return remoteConfirmed ? remoteInputs[(remoteConfirmed - 1) % NETPLAY_HISTORY] : 0;
+}
+
+
+/**
+ * @brief Sends the local inputs the peer hasn't acknowledged yet
+ *
+ * @details Packet: magic, acknowledged remote frames, first frame, count, inputs.
+ * Resending the whole unacknowledged window makes lost packets harmless.
+ */
+void RollbackSession::sendInputs(void)
+{
+    U32 first = std::max(peerAck, (frame > NETPLAY_HISTORY) ? frame - NETPLAY_HISTORY : 0);
+    U8 count = static_cast<U8>(std::min(frame - first, NETPLAY_INPUT_WINDOW));
+
+    std::array<U8, TRANSPORT_MAX_PACKET> packet;
+    StateWriter writer(packet.data(), packet.size());
+    writer.put(NETPLAY_PACKET_MAGIC);
+    writer.put(remoteConfirmed);
+    writer.put(first);
+    writer.put(count);
+
+    for(U8 i = 0; i < count; i++)
+    {
+        writer.put(localInputs[(first + i) % NETPLAY_HISTORY]);
+    }
+
+    transport.send(packet.data(), writer.size());
+}
+
+
+/**
+ * @brief Takes in every pending packet from the peer
+ *
+ * @details Remote inputs are confirmed in frame order. A confirmed input that
+ * differs from the one a past frame was simulated with schedules a rollback.
+ */
+void RollbackSession::receiveInputs(void)
+{
+    std::array<U8, TRANSPORT_MAX_PACKET> packet;
+    size_t size;
+
+    while((size = transport.receive(packet.data(), packet.size())) != 0)
+    {
+        StateReader reader(packet.data(), size);
+
+        U32 magic = 0;
+        U32 ack = 0;
+        U32 first = 0;
+        U8 count = 0;
+        reader.get(magic);
+        reader.get(ack);
+        reader.get(first);
+        reader.get(count);
+
+        if(magic != NETPLAY_PACKET_MAGIC || count > NETPLAY_INPUT_WINDOW || reader.size() + count != size)
+        {
+            continue;
+        }
+
+        peerAck = std::max(peerAck, std::min(ack, frame));
+
+        for(U8 i = 0; i < count; i++)
+        {
+            U32 inputFrame = first + i;
+            U8 buttons = 0;
+            reader.get(buttons);
+
+            // Gaps are filled by a later packet; the peer can't be further ahead than this
+            if(inputFrame != remoteConfirmed || inputFrame >= frame + maxRollback)
+            {
+                continue;
+            }
+
+            remoteInputs[inputFrame % NETPLAY_HISTORY] = buttons;
+            remoteConfirmed++;
+
+            if(inputFrame < frame && usedInputs[inputFrame % NETPLAY_HISTORY] != buttons)
+            {
+                rollbackFrom = std::min(rollbackFrom, inputFrame);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Measures how many frames a rollback can re-simulate within one frame budget
+ *
+ * @details Restores the current state, then runs frames the way a rollback does
+ * (snapshot, then frame without pixels) until NETPLAY_FRAME_BUDGET_US has passed.
+ * The console is returned to the state it had before. One of the frames is the
+ * live frame of the call, so the catch-up limit becomes one less (at least one).
+ *
+ * @return Number of frames completed within the budget
+ */
+U32 RollbackSession::measureRollbackCapacity(void)
+{
+    // The next frame's snapshot slot is free: runFrame() overwrites it anyway
+    std::vector<U8>& current = snapshots[frame % (maxRollback + 1)];
+    std::vector<U8> scratch(current.size());
+    console.saveState(current.data(), current.size());
+
+    bool suppressed = console.getPPU()->isOutputSuppressed();
+    console.getPPU()->setOutputSuppressed(true);
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::microseconds(NETPLAY_FRAME_BUDGET_US);
+    U32 frames = 0;
+
+    console.loadState(current.data(), current.size());
+    while(true)
+    {
+        console.saveState(scratch.data(), scratch.size());
+        console.stepFrame();
+
+        if(std::chrono::steady_clock::now() > deadline)
+        {
+            break;
+        }
+
+        frames++;
+    }
+
+    console.loadState(current.data(), current.size());
+    console.getPPU()->setOutputSuppressed(suppressed);
+
+    setCatchUpLimit(frames ? frames - 1 : 0);
+    return frames;
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "../inc/palette.h"
+
+#if PALETTE_AVX2
+#include <immintrin.h>
+#endif
+
+#include <cstring>
+
+
+/* 2C02 master palette (0xRRGGBB) */
+static const std::array<U32, PALETTE_COLORS> masterPalette =
+{
+    0x666666, 0x002A88, 0x1412A7, 0x3B00A4, 0x5C007E, 0x6E0040, 0x6C0600, 0x561D00,
+    0x333500, 0x0B4800, 0x005200, 0x004F08, 0x00404D, 0x000000, 0x000000, 0x000000,
+    0xADADAD, 0x155FD9, 0x4240FF, 0x7527FE, 0xA01ACC, 0xB71E7B, 0xB53120, 0x994E00,
+    0x6B6D00, 0x388700, 0x0C9300, 0x008F32, 0x007C8D, 0x000000, 0x000000, 0x000000,
+    0xFFFEFF, 0x64B0FF, 0x9290FF, 0xC676FF, 0xF36AFF, 0xFE6ECC, 0xFE8170, 0xEA9E22,
+    0xBCBE00, 0x88D800, 0x5CE430, 0x45E082, 0x48CDDE, 0x4F4F4F, 0x000000, 0x000000,
+    0xFFFEFF, 0xC0DFFF, 0xD3D2FF, 0xE8C8FF, 0xFBC2FF, 0xFEC4EA, 0xFECCC5, 0xF7D8A5,
+    0xE4E594, 0xCFEF96, 0xBDF4AB, 0xB3F3CC, 0xB5EBF2, 0xB8B8B8, 0x000000, 0x000000
+};
+
+/* The tables hold pixels as little-endian words (see rgba, bgra and rgb565 below) */
+#if defined(__BYTE_ORDER__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "palette tables assume a little-endian host");
+#endif
+
+
+/**
+ * @brief Builds the lookup table of every output format
+ *
+ * @details Entry (emphasis * PALETTE_COLORS + color) holds the pixel for a 6-bit
+ * color under the given emphasis bits (BIT0: red, BIT1: green, BIT2: blue).
+ */
+PaletteConverter::PaletteConverter()
+{
+#if PALETTE_AVX2
+    // Checked once; the AVX2 path is compiled in regardless of the build flags
+    avx2Supported = __builtin_cpu_supports("avx2");
+#else
+    avx2Supported = false;
+#endif
+    avx2 = avx2Supported;
+
+    for(U16 emphasis = 0; emphasis < PALETTE_EMPHASIS_COMBINATIONS; emphasis++)
+    {
+        for(U16 color = 0; color < PALETTE_COLORS; color++)
+        {
+            double r = (masterPalette[color] >> 16) & 0xFF;
+            double g = (masterPalette[color] >> 8) & 0xFF;
+            double b = masterPalette[color] & 0xFF;
+
+            if(emphasis & 0x01)
+            {
+                g *= PALETTE_EMPHASIS_ATTENUATION;
+                b *= PALETTE_EMPHASIS_ATTENUATION;
+            }
+            if(emphasis & 0x02)
+            {
+                r *= PALETTE_EMPHASIS_ATTENUATION;
+                b *= PALETTE_EMPHASIS_ATTENUATION;
+            }
+            if(emphasis & 0x04)
+            {
+                r *= PALETTE_EMPHASIS_ATTENUATION;
+                g *= PALETTE_EMPHASIS_ATTENUATION;
+            }
+
+            U32 red = static_cast<U32>(r + 0.5);
+            U32 green = static_cast<U32>(g + 0.5);
+            U32 blue = static_cast<U32>(b + 0.5);
+            U16 entry = emphasis * PALETTE_COLORS + color;
+
+            // Little-endian: the low byte of each word is the first byte in memory
+            rgba[entry] = 0xFF000000 | (blue << 16) | (green << 8) | red;
+            bgra[entry] = 0xFF000000 | (red << 16) | (green << 8) | blue;
+            rgb565[entry] = ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3);
+        }
+    }
+}
+
+
+/**
+ * @brief Returns the converter, building the tables on first use
+ *
+ */
+const PaletteConverter& PaletteConverter::instance(void)
+{
+    static const PaletteConverter converter;
+    return converter;
+}
+
+
+#if PALETTE_AVX2
+/**
+ * @brief Converts as many pixels of a row as fit in whole AVX2 blocks
+ *
+ * @details Built for AVX2 through the target attribute and only called when the
+ * CPU supports it, so the default build carries this path too.
+ *
+ * @return Number of pixels converted; the caller finishes the row
+ */
+__attribute__((target("avx2")))
+static U16 convertRowAVX2(const U8* src, U8* dst, const U32* rowTable, PixelFormat format)
+{
+    const __m256i colorMask = _mm256_set1_epi32(PALETTE_COLORS - 1);
+    U16 x = 0;
+
+    if(format == PixelFormat::RGB565)
+    {
+        for(; x + 16 <= PPU_SCREEN_WIDTH; x += 16)
+        {
+            __m256i lo = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+            __m256i hi = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x + 8)));
+            lo = _mm256_i32gather_epi32(reinterpret_cast<const int*>(rowTable), _mm256_and_si256(lo, colorMask), 4);
+            hi = _mm256_i32gather_epi32(reinterpret_cast<const int*>(rowTable), _mm256_and_si256(hi, colorMask), 4);
+
+            // Pack to 16 bits (per 128-bit lane), then restore pixel order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 2), packed);
+        }
+    }
+    else
+    {
+        for(; x + 8 <= PPU_SCREEN_WIDTH; x += 8)
+        {
+            __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+            __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(rowTable), _mm256_and_si256(index, colorMask), 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), pixels);
+        }
+    }
+
+    return x;
+}
+#endif
+
+
+/**
+ * @brief Converts a PPU frame buffer (PPU_FRAME_BUFFER_SIZE bytes) into
+ * PPU_SCREEN_WIDTH x PPU_SCREEN_HEIGHT pixels of the given format
+ *
+ * @param pitch Bytes between the starts of two destination rows
+ */
+void PaletteConverter::convertFrame(const U8* frameBuffer, void* destination, size_t pitch, PixelFormat format) const
+{
+    const U32* table = (format == PixelFormat::RGBA8888) ? rgba.data() :
+                       (format == PixelFormat::BGRA8888) ? bgra.data() : rgb565.data();
+
+    for(U16 row = 0; row < PPU_SCREEN_HEIGHT; row++)
+    {
+        const U8* src = frameBuffer + row * PPU_SCREEN_WIDTH;
+        U8* dst = static_cast<U8*>(destination) + row * pitch;
+        const U32* rowTable = table + (frameBuffer[PPU_EMPHASIS_OFFSET + row] & 0x07) * PALETTE_COLORS;
+        U16 x = 0;
+
+#if PALETTE_AVX2
+        if(avx2)
+        {
+            x = convertRowAVX2(src, dst, rowTable, format);
+        }
+#endif
+
+        if(format == PixelFormat::RGB565)
+        {
+            for(; x < PPU_SCREEN_WIDTH; x++)
+            {
+                U16 pixel = static_cast<U16>(rowTable[src[x] & 0x3F]);
+                std::memcpy(dst + x * 2, &pixel, sizeof(pixel));
+            }
+        }
+        else
+        {
+            for(; x < PPU_SCREEN_WIDTH; x++)
+            {
+                std::memcpy(dst + x * 4, &rowTable[src[x] & 0x3F], sizeof(U32));
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "../inc/ppupipeline.h"
+
+
+PPURenderPipeline::PPURenderPipeline(const RP2C02& source) : replica(source)
+{
+    // The replica renders locally and must not record into this pipeline or mark the console's pages
+    replica.attachPipeline(nullptr);
+    replica.attachDirtyPages(nullptr);
+
+    presented.fill(0);
+    presentedFrames = 0;
+    presentedFrame = 0;
+    frameReady = false;
+
+    // Roughly one frame worth of register traffic
+    recording.reserve(4096);
+    pending.reserve(4096);
+    recordingDMA.reserve(1024);
+    pendingDMA.reserve(1024);
+    pendingEndDot = 0;
+    pendingRender = true;
+
+    busy = false;
+    stopping = false;
+    worker = std::thread(&PPURenderPipeline::workerLoop, this);
+}
+
+
+PPURenderPipeline::~PPURenderPipeline()
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [this]{ return !busy; });
+        stopping = true;
+    }
+
+    signal.notify_all();
+    worker.join();
+}
+
+
+/**
+ * @brief Appends a command to the log of the frame in progress
+ *
+ * @param type Command type
+ * @param timestamp PPU dot count at which the command takes effect
+ * @param addr Register address, or the new setting
+ * @param data Written value
+ */
+void PPURenderPipeline::record(PPUCommandType type, U64 timestamp, U16 addr, U8 data)
+{
+    recording.push_back({timestamp, type, addr, data});
+}
+
+
+/**
+ * @brief Appends an OAM DMA to the log, with a copy of the page
+ *
+ */
+void PPURenderPipeline::recordOAMDMA(U64 timestamp, const U8* data)
+{
+    U16 block = static_cast<U16>(recordingDMA.size() / 256);
+    recordingDMA.insert(recordingDMA.end(), data, data + 256);
+    recording.push_back({timestamp, PPUCommandType::oamDMA, block, 0});
+}
+
+
+/**
+ * @brief Appends a copy of the PPU, which the replica takes over at this point
+ * of the log
+ *
+ * @details Used after the PPU was restored from a save state or got a new
+ * cartridge, instead of restarting the worker.
+ */
+void PPURenderPipeline::recordRestore(RP2C02& source)
+{
+    PPURestore snapshot;
+    snapshot.cartridge = source.getCartridge();
+
+    StateWriter size(nullptr, 0);
+    source.saveState(size);
+    snapshot.state.resize(size.size());
+
+    StateWriter state(snapshot.state.data(), snapshot.state.size());
+    source.saveState(state);
+
+    U16 index = static_cast<U16>(recordingRestores.size());
+    recordingRestores.push_back(std::move(snapshot));
+    recording.push_back({source.getDotCount(), PPUCommandType::restore, index, 0});
+}
+
+
+/**
+ * @brief Hands the recorded log to the worker
+ *
+ * @details Blocks only if the worker is still rendering the previous frame, which
+ * is then presented before the new frame is queued.
+ *
+ * @param endDot PPU dot count the replica has to reach for this frame
+ * @param render false if the frame is never shown (output suppressed): the
+ * replica only keeps its state in step and the presented frame is left alone
+ */
+void PPURenderPipeline::submitFrame(U64 endDot, bool render)
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [this]{ return !busy; });
+
+        present();
+
+        pending.swap(recording);
+        recording.clear();
+        pendingDMA.swap(recordingDMA);
+        recordingDMA.clear();
+        pendingRestores.swap(recordingRestores);
+        recordingRestores.clear();
+        pendingEndDot = endDot;
+        pendingRender = render;
+        busy = true;
+    }
+
+    signal.notify_all();
+}
+
+
+/**
+ * @brief Waits for the worker to render everything submitted so far
+ *
+ */
+void PPURenderPipeline::finish(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    signal.wait(guard, [this]{ return !busy; });
+
+    present();
+}
+
+
+/**
+ * @brief Copies the replica's completed frame to the presented buffer
+ *
+ * @details Called on the CPU thread with the worker idle.
+ */
+void PPURenderPipeline::present(void)
+{
+    const U8* frame = replica.getFrameBuffer();
+    if(!frameReady || !frame)
+    {
+        return;
+    }
+
+    std::copy(frame, frame + presented.size(), presented.begin());
+    presentedFrames++;
+    presentedFrame = replica.getFrameBufferFrame();
+    frameReady = false;
+}
+
+
+/**
+ * @brief Worker thread: renders each submitted frame
+ *
+ */
+void PPURenderPipeline::workerLoop(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while(1)
+    {
+        signal.wait(guard, [this]{ return busy || stopping; });
+
+        if(stopping)
+        {
+            return;
+        }
+
+        guard.unlock();
+        replay();
+        guard.lock();
+
+        busy = false;
+        frameReady = pendingRender;
+        signal.notify_all();
+    }
+}
+
+
+/**
+ * @brief Runs the replica through the pending frame, applying each command at its dot
+ *
+ */
+void PPURenderPipeline::replay(void)
+{
+    replica.setOutputSuppressed(!pendingRender);
+
+    for(const PPUCommand& command : pending)
+    {
+        // A restore replaces the replica's timeline, so there is nothing to catch up to
+        while(command.type != PPUCommandType::restore && replica.getDotCount() < command.timestamp)
+        {
+            replica.PPU_Cycle();
+        }
+
+        switch(command.type)
+        {
+            case PPUCommandType::registerWrite:  replica.writeRegister(command.addr, command.data); break;
+            case PPUCommandType::registerRead:   replica.readRegister(command.addr); break;
+            case PPUCommandType::renderInterval: replica.setRenderInterval(command.addr); break;
+            case PPUCommandType::mirroring:      replica.setMirroring(static_cast<Mirroring>(command.addr)); break;
+            case PPUCommandType::reset:          replica.reset(); break;
+            case PPUCommandType::oamDMA:         replica.oamDMA(&pendingDMA[command.addr * 256]); break;
+            case PPUCommandType::restore:        restore(pendingRestores[command.addr]); break;
+        }
+    }
+
+    while(replica.getDotCount() < pendingEndDot)
+    {
+        replica.PPU_Cycle();
+    }
+}
+
+
+/**
+ * @brief Replaces the replica's state (and cartridge, if it changed) with a recorded copy
+ *
+ * @details The replica keeps its own frame buffer, render interval and output
+ * suppression; those are not part of the state.
+ */
+void PPURenderPipeline::restore(const PPURestore& snapshot)
+{
+    if(replica.getCartridge() != snapshot.cartridge)
+    {
+        replica.insertCartridge(snapshot.cartridge);
+    }
+
+    StateReader state(snapshot.state.data(), snapshot.state.size());
+    replica.loadState(state);
+}
\ No newline at end of file
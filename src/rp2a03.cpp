@@ -1,374 +1,762 @@
-#include "../inc/rp2a03.h"
-
-
-RP2A03::RP2A03()
-{
-    reset();
-}
-
-RP2A03::~RP2A03(){}
-
-
-/**
- * @brief Executes a single loop of the CPU pipeline
- * 
- */
-void RP2A03::CPU_Cycle(void)
-{
-    U8 opcode = fetch();
-    Instr_t nextInstruction = decode(opcode);
-    executeInstruction(&nextInstruction);
-}
-
-
-/**
- * @brief Applies the correct addressing mode to an instruction
- * 
- * @param instr Instruction to apply addressing mode on
- */
-void RP2A03::applyAddressingMode(Instr_t* instr)
-{
-    // Addressing Mode jump table
-    switch(instr->addrMode)
-    {
-        case AddrMode::absin:
-        {
-            /* In absolute indirect addressing, the second byte of the instruction contains the
-               low order byte of a memory location. The high order byte of that memory location
-               are contained in the third byte of the instruction. */
-
-            U8 lowByte = memBus->readFromBus(PC + 1);
-            U8 highByte = memBus->readFromBus(PC + 2);
-            U16 effectiveAddress = (highByte << 8) | lowByte;
-
-            U8 targetLowByte = memBus->readFromBus(effectiveAddress);
-            U8 targetHighByte = memBus->readFromBus(effectiveAddress + 1);
-            U16 targetAddress = (targetHighByte << 8) | targetLowByte;
-
-            instr->operand = targetAddress; 
-            break;
-        }
-        case AddrMode::absol:
-        {
-            /* In absolute addressing, the second byte of the instruction specifies the eight low
-               order bits of the effective address while the third byte specifies the eight high
-               order bits */
-
-            U8 lowByte = memBus->readFromBus(PC + 1);
-            U8 highByte = memBus->readFromBus(PC + 2);
-            U16 effectiveAddress = (highByte << 8) | lowByte;
-            instr->operand = effectiveAddress;
-            break;
-        }
-        case AddrMode::accum:
-        {
-            /* In accumulator addressing, the one byte instruction implies operation on the accumulator (A)
-               register. */
-
-            instr->operand = A;
-            break;
-        }
-        case AddrMode::immed:
-        {
-            /* In immediate addressing, the second byte of the instruction contains the operand, with no
-               further memory addressing required. */
-
-            U8 immediateValue = memBus->readFromBus(PC + 1);
-            instr->operand = immediateValue;
-            break;
-        }
-        case AddrMode::impli:
-        {
-            /* In implied addressing, the address containing the operand is implicitly stated in the opcode
-               mnumonic. */
-            
-            instr->operand = 0;
-            break;
-        }
-        case AddrMode::nivim:
-        {
-            instr->operand = 0;
-            break;
-        }
-        case AddrMode::relat:
-        {
-            /* In relative addressing, the second byte of the instruction is an operand. This operand
-               is an offset which is added to the program counter when the counter is set at the next
-               instruction. The range of the offset is -128 - +127 (signed byte). */
-
-            int8_t offset = static_cast<int8_t>(memBus->readFromBus(PC + 1));
-            instr->operand = PC + offset;
-            break;
-        }
-        case AddrMode::xiabs:
-        {
-            /* In X-indexed absolute addressing, the effective address is formed by adding the contents
-             of the X register to the address contained in the second and third bytes of the instruction. */
-
-            U8 lowByte = memBus->readFromBus(PC + 1);
-            U8 highByte = memBus->readFromBus(PC + 2);
-            U16 address = (highByte << 8) | lowByte;
-
-            U16 effectiveAddress = address + X;
-            instr->operand = effectiveAddress;
-            break;
-        }
-        case AddrMode::xizpg:
-        {
-            /* In X-indexed zero page adressing, the effective address is calculated by adding the
-               second byte to the contents of the X index (X) register. Since this is a form of zero
-               page addressing, the content of the second byte references a location in zero page memory.
-               No carry is added to the high order byte of memory and crossing a page boundary does not
-               occur */
-
-            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
-            U16 effectiveAddress = (zeroPageAddress + X) & 0xFF;
-
-            // Ensure wrapping around zero page memory (0x0000 - 0x00FF)
-            effectiveAddress &= 0xFF;
-
-            instr->operand = effectiveAddress;
-            break;
-        }
-        case AddrMode::xizpi:
-        {
-            /* In X-index zero page indirect addressing, the second byte of the instruction is added to
-               the contents of the X index (X) register and discards the carry. The result of this addition
-               points to a memory location on page zero which contains the low order byte of the effective
-               address. The next memory location in page zero contains the high order byte of the effective
-               address. Both memory locations specifying the effective address must be in page zero. */
-
-            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
-            U16 effectiveAddress = zeroPageAddress + X;
-            effectiveAddress &= 0xFF;
-
-            U8 lowByte = memBus->readFromBus(effectiveAddress);
-            U8 highByte = memBus->readFromBus((effectiveAddress + 1) & 0xFF);
-            U16 finalAddress = (highByte << 8) | lowByte;
-
-            instr->operand = finalAddress;
-            break;
-        }
-        case AddrMode::yiabs:
-        {
-            /* In Y-indexed absolute addressing, the effective address is formed by adding the contents
-               of the Y register to the address contained in the second and third bytes of the instruction. */
-
-            U8 lowByte = memBus->readFromBus(PC + 1);
-            U8 highByte = memBus->readFromBus(PC + 2);
-            U16 address = (highByte << 8) | lowByte;
-
-            U16 effectiveAddress = address + Y;
-            instr->operand = effectiveAddress;
-            break;
-        }
-        case AddrMode::yizpg:
-        {
-            /* In Y-indexed zero page adressing, the effective address is calculated by adding the
-               second byte to the contents of the Y index (Y) register. Since this is a form of zero
-               page addressing, the content of the second byte references a location in zero page memory.
-               No carry is added to the high order byte of memory and crossing a page boundary does not
-               occur */
-
-            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
-            U16 effectiveAddress = zeroPageAddress + Y;
-
-            // Ensure wrapping around zero page memory (0x0000 - 0x00FF)
-            effectiveAddress &= 0xFF;
-            
-            instr->operand = effectiveAddress;
-            break;
-        }
-        case AddrMode::yizpi:
-        {
-            /* In Y-index zero page indirect addressing, the second byte of the instruction is added to
-               the contents of the Y index (Y) register and discards the carry. The result of this addition
-               points to a memory location on page zero which contains the low order byte of the effective
-               address. The next memory location in page zero contains the high order byte of the effective
-               address. Both memory locations specifying the effective address must be in page zero. */
-
-            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
-            U16 effectiveAddress = zeroPageAddress + Y;
-            effectiveAddress &= 0xFF;
-
-            U8 lowByte = memBus->readFromBus(effectiveAddress);
-            U8 highByte = memBus->readFromBus((effectiveAddress + 1) & 0xFF);
-            U16 finalAddress = (highByte << 8) | lowByte;
-
-            instr->operand = finalAddress;
-            break;
-        }
-        case AddrMode::zpage:
-        {
-            /* In zero page addressing, the second byte of the insturction contains the low order byte of a
-               memory location. The high byte of the memory location is assumed to be zero (0x00) */
-
-            U8 lowByte = memBus->readFromBus(PC + 1);
-
-            // Explicitly set the high byte to 0x00
-            U8 zeroPageAddress = 0x00FF & static_cast<U16>(lowByte);
-
-            instr->operand = zeroPageAddress;
-            break;
-        }
-        default: /* AddrMode::nivim */
-        {
-            /* Null Instruction Vector Index Mode: Invalid opcode */
-            
-            instr->operand = 0;
-            break;
-        }
-    }
-}
-
-
-/**
- * @brief Fetches the next opcode byte from memory
- * 
- * @return opcode fetched from memory 
- */
-U8 RP2A03::fetch(void)
-{
-    PC++;
-    U16 instrAddr = PC + MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR;
-    return memBus->readFromBus(instrAddr);
-}
-
-
-/**
- * @brief Decodes the current instruction opcode
- * 
- * @details Indexes the instruction array to decode the opcode
- * 
- * @param opCode Used to index the instr array
- * 
- * @return Decoded instruction 
- */
-RP2A03::Instr_t RP2A03::decode(U8 opCode)
-{
-    // Decode the opCode byte read from ROM
-    Instr_t instruction = instrArray[opCode];
-
-    // Apply the correct addressing mode on the current instruction
-    applyAddressingMode(&instruction);
-
-    return instruction;
-}
-
-
-/**
- * @brief Wrapper for executing instruction function pointers
- * 
- */
-void RP2A03::executeInstruction(Instr_t* instr)
-{
-    (this->*(instr->func))(instr->operand);
-}
-
-/**
- * @brief Executes the CPU reset vector
- * 
- */
-void RP2A03::reset()
-{
-    // Initialize status register
-    status = Flags::RESET;
-
-    // Initialize SP
-    SP = (U8)MemoryMap::MEM_RAM_STACK_BASE_ADDR;
-
-    // Initialize PC to the reset vector
-    PC = MemoryMap::MEM_INT_RESET_BASE_ADDR;
-}
-
-
-void RP2A03::NMI(){}
-void RP2A03::IRQ(){}
-
-
-/******************************************************************
- *                        Instructions                            *
- ******************************************************************/
-
-/**
- * @brief Load Accumulator with Memory
- * 
- * @param a Value to load into the accumulator 
- * @param b OperandB
- */
-void RP2A03::LDA(U16 operand)
-{
-    // Load the value of the operand into the accumulator
-    A = operand;
-
-    U8 flags = Flags::CLEAR;
-
-    // Raise status flags if needed    
-    if(A == 0)
-    {
-        flags |= Flags::ZERO_FLAG; 
-    }
-    else if(A & Flags::NEGATIVE_FLAG)
-    {
-        flags |= Flags::NEGATIVE_FLAG;
-    }
-
-    status |= flags;
-}
-
-void RP2A03::LDX(U16 operand){ (void)operand; }
-void RP2A03::LDY(U16 operand){ (void)operand; }
-void RP2A03::STA(U16 operand){ (void)operand; }
-void RP2A03::STX(U16 operand){ (void)operand; }
-void RP2A03::STY(U16 operand){ (void)operand; }
-void RP2A03::TAX(U16 operand){ (void)operand; }
-void RP2A03::TAY(U16 operand){ (void)operand; }
-void RP2A03::TSX(U16 operand){ (void)operand; }
-void RP2A03::TXA(U16 operand){ (void)operand; }
-void RP2A03::TXS(U16 operand){ (void)operand; }
-void RP2A03::TYA(U16 operand){ (void)operand; }
-void RP2A03::PHA(U16 operand){ (void)operand; }
-void RP2A03::PHP(U16 operand){ (void)operand; }
-void RP2A03::PLA(U16 operand){ (void)operand; }
-void RP2A03::PLP(U16 operand){ (void)operand; }
-void RP2A03::ASL(U16 operand){ (void)operand; }
-void RP2A03::LSR(U16 operand){ (void)operand; }
-void RP2A03::ROL(U16 operand){ (void)operand; }
-void RP2A03::ROR(U16 operand){ (void)operand; }
-void RP2A03::AND(U16 operand){ (void)operand; }
-void RP2A03::BIT(U16 operand){ (void)operand; }
-void RP2A03::EOR(U16 operand){ (void)operand; }
-void RP2A03::ORA(U16 operand){ (void)operand; }
-void RP2A03::ADC(U16 operand){ (void)operand; }
-void RP2A03::CMP(U16 operand){ (void)operand; }
-void RP2A03::CPX(U16 operand){ (void)operand; }
-void RP2A03::CPY(U16 operand){ (void)operand; }
-void RP2A03::SBC(U16 operand){ (void)operand; }
-void RP2A03::DEC(U16 operand){ (void)operand; } 
-void RP2A03::DEX(U16 operand){ (void)operand; } 
-void RP2A03::DEY(U16 operand){ (void)operand; } 
-void RP2A03::INC(U16 operand){ (void)operand; } 
-void RP2A03::INX(U16 operand){ (void)operand; }
-void RP2A03::INY(U16 operand){ (void)operand; }
-void RP2A03::BRK(U16 operand){ (void)operand; }
-void RP2A03::JMP(U16 operand){ (void)operand; }
-void RP2A03::JSR(U16 operand){ (void)operand; }
-void RP2A03::RTI(U16 operand){ (void)operand; }
-void RP2A03::RTS(U16 operand){ (void)operand; }
-void RP2A03::BCC(U16 operand){ (void)operand; }
-void RP2A03::BCS(U16 operand){ (void)operand; }
-void RP2A03::BEQ(U16 operand){ (void)operand; }
-void RP2A03::BMI(U16 operand){ (void)operand; }
-void RP2A03::BNE(U16 operand){ (void)operand; }
-void RP2A03::BPL(U16 operand){ (void)operand; } 
-void RP2A03::BVC(U16 operand){ (void)operand; }
-void RP2A03::BVS(U16 operand){ (void)operand; }
-void RP2A03::CLC(U16 operand){ (void)operand; }
-void RP2A03::CLD(U16 operand){ (void)operand; }
-void RP2A03::CLI(U16 operand){ (void)operand; }
-void RP2A03::CLV(U16 operand){ (void)operand; }
-void RP2A03::SEC(U16 operand){ (void)operand; }
-void RP2A03::SED(U16 operand){ (void)operand; }
-void RP2A03::SEI(U16 operand){ (void)operand; }
-void RP2A03::NOP(U16 operand){ (void)operand; }
-void RP2A03::NII(U16 operand){ (void)operand; }
+#include "../inc/rp2a03.h"
+
+
+/* Instruction Vector: shared by every CPU instance */
+const std::array<RP2A03::Instr_t, 256> RP2A03::instrArray = {{
+    {"BRK", AddrMode::impli, &RP2A03::BRK, 0x00, 1, 7, 0},
+    {"ORA", AddrMode::xizpi, &RP2A03::ORA, 0x01, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x02, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x03, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x04, 0, 0, 0},
+    {"ORA", AddrMode::zpage, &RP2A03::ORA, 0x05, 2, 3, 0},
+    {"ASL", AddrMode::zpage, &RP2A03::ASL, 0x06, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x07, 0, 0, 0},
+    {"PHP", AddrMode::impli, &RP2A03::PHP, 0x08, 1, 3, 0},
+    {"ORA", AddrMode::immed, &RP2A03::ORA, 0x09, 2, 2, 0},
+    {"ASL", AddrMode::accum, &RP2A03::ASL, 0x0A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x0B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x0C, 0, 0, 0},
+    {"ORA", AddrMode::absol, &RP2A03::ORA, 0x0D, 3, 4, 0},
+    {"ASL", AddrMode::absol, &RP2A03::ASL, 0x0E, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x0F, 0, 0, 0},
+    {"BPL", AddrMode::relat, &RP2A03::BPL, 0x10, 2, 2, 0},
+    {"ORA", AddrMode::yizpi, &RP2A03::ORA, 0x11, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x12, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x13, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x14, 0, 0, 0},
+    {"ORA", AddrMode::xizpg, &RP2A03::ORA, 0x15, 2, 4, 0},
+    {"ASL", AddrMode::xizpg, &RP2A03::ASL, 0x16, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x17, 0, 0, 0},
+    {"CLC", AddrMode::impli, &RP2A03::CLC, 0x18, 1, 2, 0},
+    {"ORA", AddrMode::yiabs, &RP2A03::ORA, 0x19, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x1A, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x1B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x1C, 0, 0, 0},
+    {"ORA", AddrMode::xiabs, &RP2A03::ORA, 0x1D, 3, 4, 0},
+    {"ASL", AddrMode::xiabs, &RP2A03::ASL, 0x1E, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x1F, 0, 0, 0},
+    {"JSR", AddrMode::absol, &RP2A03::JSR, 0x20, 3, 6, 0},
+    {"AND", AddrMode::xizpi, &RP2A03::AND, 0x21, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x22, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x23, 0, 0, 0},
+    {"BIT", AddrMode::zpage, &RP2A03::BIT, 0x24, 2, 3, 0},
+    {"AND", AddrMode::zpage, &RP2A03::AND, 0x25, 2, 3, 0},
+    {"ROL", AddrMode::zpage, &RP2A03::ROL, 0x26, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x27, 0, 0, 0},
+    {"PLP", AddrMode::impli, &RP2A03::PLP, 0x28, 1, 4, 0},
+    {"AND", AddrMode::immed, &RP2A03::AND, 0x29, 2, 2, 0},
+    {"ROL", AddrMode::accum, &RP2A03::ROL, 0x2A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x2B, 0, 0, 0},
+    {"BIT", AddrMode::absol, &RP2A03::BIT, 0x2C, 3, 4, 0},
+    {"AND", AddrMode::absol, &RP2A03::AND, 0x2D, 3, 4, 0},
+    {"ROL", AddrMode::absol, &RP2A03::ROL, 0x2E, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x2F, 0, 0, 0},
+    {"BMI", AddrMode::relat, &RP2A03::BMI, 0x30, 2, 2, 0},
+    {"AND", AddrMode::yizpi, &RP2A03::AND, 0x31, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x32, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x33, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x34, 0, 0, 0},
+    {"AND", AddrMode::xizpg, &RP2A03::AND, 0x35, 2, 4, 0},
+    {"ROL", AddrMode::xizpg, &RP2A03::ROL, 0x36, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x37, 0, 0, 0},
+    {"SEC", AddrMode::impli, &RP2A03::SEC, 0x38, 1, 2, 0},
+    {"AND", AddrMode::yiabs, &RP2A03::AND, 0x39, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x3A, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x3B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x3C, 0, 0, 0},
+    {"AND", AddrMode::xiabs, &RP2A03::AND, 0x3D, 3, 4, 0},
+    {"ROL", AddrMode::xiabs, &RP2A03::ROL, 0x3E, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x3F, 0, 0, 0},
+    {"RTI", AddrMode::impli, &RP2A03::RTI, 0x40, 1, 6, 0},
+    {"EOR", AddrMode::xizpi, &RP2A03::EOR, 0x41, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x42, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x43, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x44, 0, 0, 0},
+    {"EOR", AddrMode::zpage, &RP2A03::EOR, 0x45, 2, 3, 0},
+    {"LSR", AddrMode::zpage, &RP2A03::LSR, 0x46, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x47, 0, 0, 0},
+    {"PHA", AddrMode::impli, &RP2A03::PHA, 0x48, 1, 3, 0},
+    {"EOR", AddrMode::immed, &RP2A03::EOR, 0x49, 2, 2, 0},
+    {"LSR", AddrMode::accum, &RP2A03::LSR, 0x4A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x4B, 0, 0, 0},
+    {"JMP", AddrMode::absol, &RP2A03::JMP, 0x4C, 3, 3, 0},
+    {"EOR", AddrMode::absol, &RP2A03::EOR, 0x4D, 3, 4, 0},
+    {"LSR", AddrMode::absol, &RP2A03::LSR, 0x4E, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x4F, 0, 0, 0},
+    {"BVC", AddrMode::relat, &RP2A03::BVC, 0x50, 2, 2, 0},
+    {"EOR", AddrMode::yizpi, &RP2A03::EOR, 0x51, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x52, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x53, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x54, 0, 0, 0},
+    {"EOR", AddrMode::xizpg, &RP2A03::EOR, 0x55, 2, 4, 0},
+    {"LSR", AddrMode::xizpg, &RP2A03::LSR, 0x56, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x57, 0, 0, 0},
+    {"CLI", AddrMode::impli, &RP2A03::CLI, 0x58, 1, 2, 0},
+    {"EOR", AddrMode::yiabs, &RP2A03::EOR, 0x59, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x5A, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x5B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x5C, 0, 0, 0},
+    {"EOR", AddrMode::xiabs, &RP2A03::EOR, 0x5D, 3, 4, 0},
+    {"LSR", AddrMode::xiabs, &RP2A03::LSR, 0x5E, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x5F, 0, 0, 0},
+    {"RTS", AddrMode::impli, &RP2A03::RTS, 0x60, 1, 6, 0},
+    {"ADC", AddrMode::xizpi, &RP2A03::ADC, 0x61, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x62, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x63, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x64, 0, 0, 0},
+    {"ADC", AddrMode::zpage, &RP2A03::ADC, 0x65, 2, 3, 0},
+    {"ROR", AddrMode::zpage, &RP2A03::ROR, 0x66, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x67, 0, 0, 0},
+    {"PLA", AddrMode::impli, &RP2A03::PLA, 0x68, 1, 4, 0},
+    {"ADC", AddrMode::immed, &RP2A03::ADC, 0x69, 2, 2, 0},
+    {"ROR", AddrMode::accum, &RP2A03::ROR, 0x6A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x6B, 0, 0, 0},
+    {"JMP", AddrMode::absin, &RP2A03::JMP, 0x6C, 3, 5, 0},
+    {"ADC", AddrMode::absol, &RP2A03::ADC, 0x6D, 3, 4, 0},
+    {"ROR", AddrMode::absol, &RP2A03::ROR, 0x6E, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x6F, 0, 0, 0},
+    {"BVS", AddrMode::relat, &RP2A03::BVS, 0x70, 2, 2, 0},
+    {"ADC", AddrMode::yizpi, &RP2A03::ADC, 0x71, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x72, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x73, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x74, 0, 0, 0},
+    {"ADC", AddrMode::xizpg, &RP2A03::ADC, 0x75, 2, 4, 0},
+    {"ROR", AddrMode::xizpg, &RP2A03::ROR, 0x76, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x77, 0, 0, 0},
+    {"SEI", AddrMode::impli, &RP2A03::SEI, 0x78, 1, 2, 0},
+    {"ADC", AddrMode::yiabs, &RP2A03::ADC, 0x79, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x7A, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x7B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x7C, 0, 0, 0},
+    {"ADC", AddrMode::xiabs, &RP2A03::ADC, 0x7D, 3, 4, 0},
+    {"ROR", AddrMode::xiabs, &RP2A03::ROR, 0x7E, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x7F, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x80, 0, 0, 0},
+    {"STA", AddrMode::xizpi, &RP2A03::STA, 0x81, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x82, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x83, 0, 0, 0},
+    {"STY", AddrMode::zpage, &RP2A03::STY, 0x84, 2, 3, 0},
+    {"STA", AddrMode::zpage, &RP2A03::STA, 0x85, 2, 3, 0},
+    {"STX", AddrMode::zpage, &RP2A03::STX, 0x86, 2, 3, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x87, 0, 0, 0},
+    {"DEY", AddrMode::impli, &RP2A03::DEY, 0x88, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x89, 0, 0, 0},
+    {"TXA", AddrMode::impli, &RP2A03::TXA, 0x8A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x8B, 0, 0, 0},
+    {"STY", AddrMode::absol, &RP2A03::STY, 0x8C, 3, 4, 0},
+    {"STA", AddrMode::absol, &RP2A03::STA, 0x8D, 3, 4, 0},
+    {"STX", AddrMode::absol, &RP2A03::STX, 0x8E, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x8F, 0, 0, 0},
+    {"BCC", AddrMode::relat, &RP2A03::BCC, 0x90, 2, 2, 0},
+    {"STA", AddrMode::yizpi, &RP2A03::STA, 0x91, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x92, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x93, 0, 0, 0},
+    {"STY", AddrMode::xizpg, &RP2A03::STY, 0x94, 2, 4, 0},
+    {"STA", AddrMode::xizpg, &RP2A03::STA, 0x95, 2, 4, 0},
+    {"STX", AddrMode::yizpg, &RP2A03::STX, 0x96, 2, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x97, 0, 0, 0},
+    {"TYA", AddrMode::impli, &RP2A03::TYA, 0x98, 1, 2, 0},
+    {"STA", AddrMode::yiabs, &RP2A03::STA, 0x99, 3, 5, 0},
+    {"TSX", AddrMode::impli, &RP2A03::TSX, 0x9A, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x9B, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x9C, 0, 0, 0},
+    {"STA", AddrMode::xiabs, &RP2A03::STA, 0x9D, 3, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x9E, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0x9F, 0, 0, 0},
+    {"LDY", AddrMode::immed, &RP2A03::LDY, 0xA0, 2, 2, 0},
+    {"LDA", AddrMode::xizpi, &RP2A03::LDA, 0xA1, 2, 6, 0},
+    {"LDX", AddrMode::immed, &RP2A03::LDX, 0xA2, 2, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xA3, 0, 0, 0},
+    {"LDY", AddrMode::zpage, &RP2A03::LDY, 0xA4, 2, 3, 0},
+    {"LDA", AddrMode::zpage, &RP2A03::LDA, 0xA5, 2, 3, 0},
+    {"LDX", AddrMode::zpage, &RP2A03::LDX, 0xA6, 2, 3, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xA7, 0, 0, 0},
+    {"TAY", AddrMode::impli, &RP2A03::TAY, 0xA8, 1, 2, 0},
+    {"LDA", AddrMode::immed, &RP2A03::LDA, 0xA9, 2, 2, 0},
+    {"TAX", AddrMode::impli, &RP2A03::TAX, 0xAA, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xAB, 0, 0, 0},
+    {"LDY", AddrMode::absol, &RP2A03::LDY, 0xAC, 3, 4, 0},
+    {"LDA", AddrMode::absol, &RP2A03::LDA, 0xAD, 3, 4, 0},
+    {"LDX", AddrMode::absol, &RP2A03::LDX, 0xAE, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xAF, 0, 0, 0},
+    {"BCS", AddrMode::relat, &RP2A03::BCS, 0xB0, 2, 2, 0},
+    {"LDA", AddrMode::yizpi, &RP2A03::LDA, 0xB1, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xB2, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xB3, 0, 0, 0},
+    {"LDY", AddrMode::xizpg, &RP2A03::LDY, 0xB4, 2, 4, 0},
+    {"LDA", AddrMode::xizpg, &RP2A03::LDA, 0xB5, 2, 4, 0},
+    {"LDX", AddrMode::yizpg, &RP2A03::LDX, 0xB6, 2, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xB7, 0, 0, 0},
+    {"CLV", AddrMode::impli, &RP2A03::CLV, 0xB8, 1, 2, 0},
+    {"LDA", AddrMode::yiabs, &RP2A03::LDA, 0xB9, 3, 4, 0},
+    {"TSX", AddrMode::impli, &RP2A03::TSX, 0xBA, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xBB, 0, 0, 0},
+    {"LDY", AddrMode::xiabs, &RP2A03::LDY, 0xBC, 3, 4, 0},
+    {"LDA", AddrMode::xiabs, &RP2A03::LDA, 0xBD, 3, 4, 0},
+    {"LDX", AddrMode::yiabs, &RP2A03::LDX, 0xBE, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xBF, 0, 0, 0},
+    {"CPY", AddrMode::immed, &RP2A03::CPY, 0xC0, 2, 2, 0},
+    {"CMP", AddrMode::xizpi, &RP2A03::CMP, 0xC1, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xC2, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xC3, 0, 0, 0},
+    {"CPY", AddrMode::zpage, &RP2A03::CPY, 0xC4, 2, 3, 0},
+    {"CMP", AddrMode::zpage, &RP2A03::CMP, 0xC5, 2, 3, 0},
+    {"DEC", AddrMode::zpage, &RP2A03::DEC, 0xC6, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xC7, 0, 0, 0},
+    {"INY", AddrMode::impli, &RP2A03::INY, 0xC8, 1, 2, 0},
+    {"CMP", AddrMode::immed, &RP2A03::CMP, 0xC9, 2, 2, 0},
+    {"DEX", AddrMode::impli, &RP2A03::DEX, 0xCA, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xCB, 0, 0, 0},
+    {"CPY", AddrMode::absol, &RP2A03::CPY, 0xCC, 3, 4, 0},
+    {"CMP", AddrMode::absol, &RP2A03::CMP, 0xCD, 3, 4, 0},
+    {"DEC", AddrMode::immed, &RP2A03::DEC, 0xCE, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xCF, 0, 0, 0},
+    {"BNE", AddrMode::relat, &RP2A03::BNE, 0xD0, 2, 2, 0},
+    {"CMP", AddrMode::yizpi, &RP2A03::CMP, 0xD1, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xD2, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xD3, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xD4, 0, 0, 0},
+    {"CMP", AddrMode::xizpg, &RP2A03::CMP, 0xD5, 2, 4, 0},
+    {"DEC", AddrMode::xizpg, &RP2A03::DEC, 0xD6, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xD7, 0, 0, 0},
+    {"CLD", AddrMode::impli, &RP2A03::CLD, 0xD8, 1, 2, 0},
+    {"CMP", AddrMode::yiabs, &RP2A03::CMP, 0xD9, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xDA, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xDB, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xDC, 0, 0, 0},
+    {"CMP", AddrMode::xiabs, &RP2A03::CMP, 0xDD, 3, 4, 0},
+    {"DEC", AddrMode::xiabs, &RP2A03::DEC, 0xDE, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xDF, 0, 0, 0},
+    {"CPX", AddrMode::immed, &RP2A03::CPX, 0xE0, 2, 2, 0},
+    {"SBC", AddrMode::xizpi, &RP2A03::SBC, 0xE1, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xE2, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xE3, 0, 0, 0},
+    {"CPX", AddrMode::zpage, &RP2A03::CPX, 0xE4, 2, 3, 0},
+    {"SBC", AddrMode::zpage, &RP2A03::SBC, 0xE5, 2, 3, 0},
+    {"INC", AddrMode::zpage, &RP2A03::INC, 0xE6, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xE7, 0, 0, 0},
+    {"INX", AddrMode::impli, &RP2A03::INX, 0xE8, 1, 2, 0},
+    {"SBC", AddrMode::immed, &RP2A03::SBC, 0xE9, 2, 2, 0},
+    {"NOP", AddrMode::impli, &RP2A03::NOP, 0xEA, 1, 2, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xEB, 0, 0, 0},
+    {"CPX", AddrMode::absol, &RP2A03::CPX, 0xEC, 3, 4, 0},
+    {"SBC", AddrMode::absol, &RP2A03::SBC, 0xED, 3, 4, 0},
+    {"INC", AddrMode::absol, &RP2A03::INC, 0xEE, 3, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xEF, 0, 0, 0},
+    {"BEQ", AddrMode::relat, &RP2A03::BEQ, 0xF0, 2, 2, 0},
+    {"SBC", AddrMode::yizpi, &RP2A03::SBC, 0xF1, 2, 5, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xF2, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xF3, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xF4, 0, 0, 0},
+    {"SBC", AddrMode::xizpg, &RP2A03::SBC, 0xF5, 2, 4, 0},
+    {"INC", AddrMode::xizpg, &RP2A03::INC, 0xF6, 2, 6, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xF7, 0, 0, 0},
+    {"SED", AddrMode::impli, &RP2A03::SED, 0xF8, 1, 2, 0},
+    {"SBC", AddrMode::yiabs, &RP2A03::SBC, 0xF9, 3, 4, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xFA, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xFB, 0, 0, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xFC, 0, 0, 0},
+    {"SBC", AddrMode::xiabs, &RP2A03::SBC, 0xFD, 3, 4, 0},
+    {"INC", AddrMode::xiabs, &RP2A03::INC, 0xFE, 3, 7, 0},
+    {"NII", AddrMode::nivim, &RP2A03::NII, 0xFF, 0, 0, 0},
+}};
+
+
+RP2A03::RP2A03()
+{
+    memBus = nullptr;
+    cycles = 0;
+    A = 0;
+    X = 0;
+    Y = 0;
+    reset();
+}
+
+RP2A03::~RP2A03(){}
+
+
+/**
+ * @brief Executes a single loop of the CPU pipeline
+ * 
+ */
+void RP2A03::CPU_Cycle(void)
+{
+    U8 opcode = fetch();
+    Instr_t nextInstruction = decode(opcode);
+    executeInstruction(&nextInstruction);
+    cycles += nextInstruction.cycles;
+}
+
+
+/**
+ * @brief Applies the correct addressing mode to an instruction
+ * 
+ * @param instr Instruction to apply addressing mode on
+ */
+void RP2A03::applyAddressingMode(Instr_t* instr)
+{
+    // Addressing Mode jump table
+    switch(instr->addrMode)
+    {
+        case AddrMode::absin:
+        {
+            /* In absolute indirect addressing, the second byte of the instruction contains the
+               low order byte of a memory location. The high order byte of that memory location
+               are contained in the third byte of the instruction. */
+
+            U8 lowByte = memBus->readFromBus(PC + 1);
+            U8 highByte = memBus->readFromBus(PC + 2);
+            U16 effectiveAddress = (highByte << 8) | lowByte;
+
+            U8 targetLowByte = memBus->readFromBus(effectiveAddress);
+            U8 targetHighByte = memBus->readFromBus(effectiveAddress + 1);
+            U16 targetAddress = (targetHighByte << 8) | targetLowByte;
+
+            instr->operand = targetAddress; 
+            break;
+        }
+        case AddrMode::absol:
+        {
+            /* In absolute addressing, the second byte of the instruction specifies the eight low
+               order bits of the effective address while the third byte specifies the eight high
+               order bits */
+
+            U8 lowByte = memBus->readFromBus(PC + 1);
+            U8 highByte = memBus->readFromBus(PC + 2);
+            U16 effectiveAddress = (highByte << 8) | lowByte;
+            instr->operand = effectiveAddress;
+            break;
+        }
+        case AddrMode::accum:
+        {
+            /* In accumulator addressing, the one byte instruction implies operation on the accumulator (A)
+               register. */
+
+            instr->operand = A;
+            break;
+        }
+        case AddrMode::immed:
+        {
+            /* In immediate addressing, the second byte of the instruction contains the operand, with no
+               further memory addressing required. */
+
+            U8 immediateValue = memBus->readFromBus(PC + 1);
+            instr->operand = immediateValue;
+            break;
+        }
+        case AddrMode::impli:
+        {
+            /* In implied addressing, the address containing the operand is implicitly stated in the opcode
+               mnumonic. */
+            
+            instr->operand = 0;
+            break;
+        }
+        case AddrMode::nivim:
+        {
+            instr->operand = 0;
+            break;
+        }
+        case AddrMode::relat:
+        {
+            /* In relative addressing, the second byte of the instruction is an operand. This operand
+               is an offset which is added to the program counter when the counter is set at the next
+               instruction. The range of the offset is -128 - +127 (signed byte). */
+
+            int8_t offset = static_cast<int8_t>(memBus->readFromBus(PC + 1));
+            instr->operand = PC + offset;
+            break;
+        }
+        case AddrMode::xiabs:
+        {
+            /* In X-indexed absolute addressing, the effective address is formed by adding the contents
+             of the X register to the address contained in the second and third bytes of the instruction. */
+
+            U8 lowByte = memBus->readFromBus(PC + 1);
+            U8 highByte = memBus->readFromBus(PC + 2);
+            U16 address = (highByte << 8) | lowByte;
+
+            U16 effectiveAddress = address + X;
+            instr->operand = effectiveAddress;
+            break;
+        }
+        case AddrMode::xizpg:
+        {
+            /* In X-indexed zero page adressing, the effective address is calculated by adding the
+               second byte to the contents of the X index (X) register. Since this is a form of zero
+               page addressing, the content of the second byte references a location in zero page memory.
+               No carry is added to the high order byte of memory and crossing a page boundary does not
+               occur */
+
+            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
+            U16 effectiveAddress = (zeroPageAddress + X) & 0xFF;
+
+            // Ensure wrapping around zero page memory (0x0000 - 0x00FF)
+            effectiveAddress &= 0xFF;
+
+            instr->operand = effectiveAddress;
+            break;
+        }
+        case AddrMode::xizpi:
+        {
+            /* In X-index zero page indirect addressing, the second byte of the instruction is added to
+               the contents of the X index (X) register and discards the carry. The result of this addition
+               points to a memory location on page zero which contains the low order byte of the effective
+               address. The next memory location in page zero contains the high order byte of the effective
+               address. Both memory locations specifying the effective address must be in page zero. */
+
+            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
+            U16 effectiveAddress = zeroPageAddress + X;
+            effectiveAddress &= 0xFF;
+
+            U8 lowByte = memBus->readFromBus(effectiveAddress);
+            U8 highByte = memBus->readFromBus((effectiveAddress + 1) & 0xFF);
+            U16 finalAddress = (highByte << 8) | lowByte;
+
+            instr->operand = finalAddress;
+            break;
+        }
+        case AddrMode::yiabs:
+        {
+            /* In Y-indexed absolute addressing, the effective address is formed by adding the contents
+               of the Y register to the address contained in the second and third bytes of the instruction. */
+
+            U8 lowByte = memBus->readFromBus(PC + 1);
+            U8 highByte = memBus->readFromBus(PC + 2);
+            U16 address = (highByte << 8) | lowByte;
+
+            U16 effectiveAddress = address + Y;
+            instr->operand = effectiveAddress;
+            break;
+        }
+        case AddrMode::yizpg:
+        {
+            /* In Y-indexed zero page adressing, the effective address is calculated by adding the
+               second byte to the contents of the Y index (Y) register. Since this is a form of zero
+               page addressing, the content of the second byte references a location in zero page memory.
+               No carry is added to the high order byte of memory and crossing a page boundary does not
+               occur */
+
+            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
+            U16 effectiveAddress = zeroPageAddress + Y;
+
+            // Ensure wrapping around zero page memory (0x0000 - 0x00FF)
+            effectiveAddress &= 0xFF;
+            
+            instr->operand = effectiveAddress;
+            break;
+        }
+        case AddrMode::yizpi:
+        {
+            /* In Y-index zero page indirect addressing, the second byte of the instruction is added to
+               the contents of the Y index (Y) register and discards the carry. The result of this addition
+               points to a memory location on page zero which contains the low order byte of the effective
+               address. The next memory location in page zero contains the high order byte of the effective
+               address. Both memory locations specifying the effective address must be in page zero. */
+
+            U8 zeroPageAddress = memBus->readFromBus(PC + 1);
+            U16 effectiveAddress = zeroPageAddress + Y;
+            effectiveAddress &= 0xFF;
+
+            U8 lowByte = memBus->readFromBus(effectiveAddress);
+            U8 highByte = memBus->readFromBus((effectiveAddress + 1) & 0xFF);
+            U16 finalAddress = (highByte << 8) | lowByte;
+
+            instr->operand = finalAddress;
+            break;
+        }
+        case AddrMode::zpage:
+        {
+            /* In zero page addressing, the second byte of the insturction contains the low order byte of a
+               memory location. The high byte of the memory location is assumed to be zero (0x00) */
+
+            U8 lowByte = memBus->readFromBus(PC + 1);
+
+            // Explicitly set the high byte to 0x00
+            U8 zeroPageAddress = 0x00FF & static_cast<U16>(lowByte);
+
+            instr->operand = zeroPageAddress;
+            break;
+        }
+        default: /* AddrMode::nivim */
+        {
+            /* Null Instruction Vector Index Mode: Invalid opcode */
+            
+            instr->operand = 0;
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Fetches the next opcode byte from memory
+ * 
+ * @return opcode fetched from memory 
+ */
+U8 RP2A03::fetch(void)
+{
+    PC++;
+    U16 instrAddr = PC + MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR;
+    return memBus->readFromBus(instrAddr);
+}
+
+
+/**
+ * @brief Decodes the current instruction opcode
+ * 
+ * @details Indexes the instruction array to decode the opcode
+ * 
+ * @param opCode Used to index the instr array
+ * 
+ * @return Decoded instruction 
+ */
+RP2A03::Instr_t RP2A03::decode(U8 opCode)
+{
+    // Decode the opCode byte read from ROM
+    Instr_t instruction = instrArray[opCode];
+
+    // Apply the correct addressing mode on the current instruction
+    applyAddressingMode(&instruction);
+
+    return instruction;
+}
+
+
+/**
+ * @brief Wrapper for executing instruction function pointers
+ * 
+ */
+void RP2A03::executeInstruction(Instr_t* instr)
+{
+    (this->*(instr->func))(instr->operand);
+}
+
+/**
+ * @brief Serializes the CPU registers
+ *
+ */
+void RP2A03::saveState(StateWriter& state)
+{
+    state.put(PC);
+    state.put(SP);
+    state.put(A);
+    state.put(X);
+    state.put(Y);
+    state.put(status);
+    state.putCounter(cycles);
+}
+
+
+/**
+ * @brief Restores the CPU registers
+ *
+ */
+void RP2A03::loadState(StateReader& state)
+{
+    state.get(PC);
+    state.get(SP);
+    state.get(A);
+    state.get(X);
+    state.get(Y);
+    state.get(status);
+    state.getCounter(cycles);
+}
+
+
+/**
+ * @brief Executes the CPU reset vector
+ * 
+ */
+void RP2A03::reset()
+{
+    // Initialize status register
+    status = Flags::RESET;
+
+    // Initialize SP
+    SP = (U8)MemoryMap::MEM_RAM_STACK_BASE_ADDR;
+
+    // Initialize PC from the reset vector
+    PC = readVector(MemoryMap::MEM_INT_RESET_BASE_ADDR);
+}
+
+
+/**
+ * @brief Sets every register at once (used to seed and mirror other CPU engines)
+ *
+ */
+void RP2A03::setRegisters(U16 pc, U8 sp, U8 a, U8 x, U8 y, U8 flags)
+{
+    PC = pc;
+    SP = sp;
+    A = a;
+    X = x;
+    Y = y;
+    status = flags;
+}
+
+
+/**
+ * @brief Non-maskable interrupt entry (the bus detects the NMI edge)
+ *
+ */
+void RP2A03::NMI(void)
+{
+    enterInterrupt(MemoryMap::MEM_INT_NMI_BASE_ADDR);
+}
+
+
+/**
+ * @brief Maskable interrupt entry, taken only while the interrupt disable flag is clear
+ *
+ */
+void RP2A03::IRQ(void)
+{
+    if(status & Flags::INTERRUPT_DISABLE_FLAG)
+    {
+        return;
+    }
+
+    enterInterrupt(MemoryMap::MEM_INT_IRQ_BASE_ADDR);
+}
+
+
+/**
+ * @brief Pushes a byte onto the stack (0x0100 - 0x01FF)
+ *
+ */
+void RP2A03::push(U8 data)
+{
+    memBus->writeToBus(MemoryMap::MEM_RAM_STACK_BASE_ADDR | SP, data);
+    SP--;
+}
+
+
+/**
+ * @brief Reads a 16-bit interrupt vector (low byte first) through the bus
+ *
+ * @details The constructor resets the CPU before a bus is connected; until then
+ * the vector address itself is used.
+ *
+ * @param vector Interrupt vector address ($FFFA, $FFFC or $FFFE)
+ * @return Address stored in the vector
+ */
+U16 RP2A03::readVector(U16 vector)
+{
+    if(memBus == nullptr)
+    {
+        return vector;
+    }
+
+    U8 lowByte = memBus->readFromBus(vector);
+    U8 highByte = memBus->readFromBus(vector + 1);
+    return (highByte << 8) | lowByte;
+}
+
+
+/**
+ * @brief Pushes PC and status, masks IRQs and continues at the interrupt vector
+ *
+ * @details Like reset(), PC is loaded from the vector. The pushed status has
+ * the break flag clear, which tells RTI code apart from BRK.
+ *
+ * @param vector Interrupt vector address
+ */
+void RP2A03::enterInterrupt(U16 vector)
+{
+    push(PC >> 8);
+    push(PC & 0xFF);
+    push((status & ~Flags::BREAK_FLAG) | Flags::UNUSED_FLAG);
+
+    status |= Flags::INTERRUPT_DISABLE_FLAG;
+    PC = readVector(vector);
+    cycles += 7;
+}
+
+
+/******************************************************************
+ *                        Instructions                            *
+ ******************************************************************/
+
+/**
+ * @brief Load Accumulator with Memory
+ * 
+ * @param a Value to load into the accumulator 
+ * @param b OperandB
+ */
+void RP2A03::LDA(U16 operand)
+{
+    // Load the value of the operand into the accumulator
+    A = operand;
+
+    U8 flags = Flags::CLEAR;
+
+    // Raise status flags if needed    
+    if(A == 0)
+    {
+        flags |= Flags::ZERO_FLAG; 
+    }
+    else if(A & Flags::NEGATIVE_FLAG)
+    {
+        flags |= Flags::NEGATIVE_FLAG;
+    }
+
+    status |= flags;
+}
+
+void RP2A03::LDX(U16 operand){ (void)operand; }
+void RP2A03::LDY(U16 operand){ (void)operand; }
+void RP2A03::STA(U16 operand){ (void)operand; }
+void RP2A03::STX(U16 operand){ (void)operand; }
+void RP2A03::STY(U16 operand){ (void)operand; }
+void RP2A03::TAX(U16 operand){ (void)operand; }
+void RP2A03::TAY(U16 operand){ (void)operand; }
+void RP2A03::TSX(U16 operand){ (void)operand; }
+void RP2A03::TXA(U16 operand){ (void)operand; }
+void RP2A03::TXS(U16 operand){ (void)operand; }
+void RP2A03::TYA(U16 operand){ (void)operand; }
+void RP2A03::PHA(U16 operand){ (void)operand; }
+void RP2A03::PHP(U16 operand){ (void)operand; }
+void RP2A03::PLA(U16 operand){ (void)operand; }
+void RP2A03::PLP(U16 operand){ (void)operand; }
+void RP2A03::ASL(U16 operand){ (void)operand; }
+void RP2A03::LSR(U16 operand){ (void)operand; }
+void RP2A03::ROL(U16 operand){ (void)operand; }
+void RP2A03::ROR(U16 operand){ (void)operand; }
+void RP2A03::AND(U16 operand){ (void)operand; }
+void RP2A03::BIT(U16 operand){ (void)operand; }
+void RP2A03::EOR(U16 operand){ (void)operand; }
+void RP2A03::ORA(U16 operand){ (void)operand; }
+void RP2A03::ADC(U16 operand){ (void)operand; }
+void RP2A03::CMP(U16 operand){ (void)operand; }
+void RP2A03::CPX(U16 operand){ (void)operand; }
+void RP2A03::CPY(U16 operand){ (void)operand; }
+void RP2A03::SBC(U16 operand){ (void)operand; }
+void RP2A03::DEC(U16 operand){ (void)operand; } 
+void RP2A03::DEX(U16 operand){ (void)operand; } 
+void RP2A03::DEY(U16 operand){ (void)operand; } 
+void RP2A03::INC(U16 operand){ (void)operand; } 
+void RP2A03::INX(U16 operand){ (void)operand; }
+void RP2A03::INY(U16 operand){ (void)operand; }
+void RP2A03::BRK(U16 operand){ (void)operand; }
+void RP2A03::JMP(U16 operand){ (void)operand; }
+void RP2A03::JSR(U16 operand){ (void)operand; }
+void RP2A03::RTI(U16 operand){ (void)operand; }
+void RP2A03::RTS(U16 operand){ (void)operand; }
+void RP2A03::BCC(U16 operand){ (void)operand; }
+void RP2A03::BCS(U16 operand){ (void)operand; }
+void RP2A03::BEQ(U16 operand){ (void)operand; }
+void RP2A03::BMI(U16 operand){ (void)operand; }
+void RP2A03::BNE(U16 operand){ (void)operand; }
+void RP2A03::BPL(U16 operand){ (void)operand; } 
+void RP2A03::BVC(U16 operand){ (void)operand; }
+void RP2A03::BVS(U16 operand){ (void)operand; }
+void RP2A03::CLC(U16 operand){ (void)operand; }
+void RP2A03::CLD(U16 operand){ (void)operand; }
+void RP2A03::CLI(U16 operand){ (void)operand; }
+void RP2A03::CLV(U16 operand){ (void)operand; }
+void RP2A03::SEC(U16 operand){ (void)operand; }
+void RP2A03::SED(U16 operand){ (void)operand; }
+void RP2A03::SEI(U16 operand){ (void)operand; }
+void RP2A03::NOP(U16 operand){ (void)operand; }
+void RP2A03::NII(U16 operand){ (void)operand; }
@@ -0,0 +1,457 @@
+#include "../inc/rp2a03lockstep.h"
+
+#if LOCKSTEP_SIMD
+#include <immintrin.h>
+#endif
+
+
+RP2A03Lockstep::RP2A03Lockstep()
+{
+    ram.assign(LOCKSTEP_RAM_SIZE * LOCKSTEP_LANES, 0);
+    buses.fill(nullptr);
+
+    A.fill(0);
+    X.fill(0);
+    Y.fill(0);
+    cycles.fill(0);
+    opcode.fill(0);
+    operand.fill(0);
+
+    activeLanes = ~static_cast<LaneMask>(0);
+
+    // Checked once; the SIMD kernels are compiled in regardless of the build flags
+    supportedISA = LockstepISA::portable;
+#if LOCKSTEP_SIMD
+    if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+    {
+        supportedISA = LockstepISA::avx512;
+    }
+    else if(__builtin_cpu_supports("avx2"))
+    {
+        supportedISA = LockstepISA::avx2;
+    }
+#endif
+    isa = supportedISA;
+
+    reset();
+}
+
+RP2A03Lockstep::~RP2A03Lockstep(){}
+
+
+/**
+ * @brief Executes the CPU reset vector on every lane
+ *
+ */
+void RP2A03Lockstep::reset(void)
+{
+    status.fill(Flags::RESET);
+    SP.fill((U8)MemoryMap::MEM_RAM_STACK_BASE_ADDR);
+
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        PC[lane] = readVector(lane, MemoryMap::MEM_INT_RESET_BASE_ADDR);
+    }
+}
+
+
+/**
+ * @brief Selects the instruction set of the lane kernels
+ *
+ * @details Sets the CPU can't run fall back to the best one it can, so this
+ * only ever steps down (e.g. to compare or benchmark the portable kernels).
+ */
+void RP2A03Lockstep::setISA(LockstepISA requested)
+{
+    isa = (static_cast<U8>(requested) < static_cast<U8>(supportedISA)) ? supportedISA : requested;
+}
+
+
+/**
+ * @brief Sets the registers of a single lane
+ *
+ */
+void RP2A03Lockstep::setRegisters(U32 lane, U16 pc, U8 sp, U8 a, U8 x, U8 y, U8 flags)
+{
+    PC[lane] = pc;
+    SP[lane] = sp;
+    A[lane] = a;
+    X[lane] = x;
+    Y[lane] = y;
+    status[lane] = flags;
+}
+
+
+/**
+ * @brief Copies a scalar CPU and its internal RAM into a lane
+ *
+ * @param lane Destination lane
+ * @param cpu Source CPU
+ * @param internalRam 2 KB of internal RAM (NESMemory::getRAM())
+ */
+void RP2A03Lockstep::loadLane(U32 lane, RP2A03& cpu, const U8* internalRam)
+{
+    setRegisters(lane, cpu.getPC(), cpu.getSP(), cpu.getA(), cpu.getX(), cpu.getY(), cpu.getStatus());
+    cycles[lane] = cpu.getCycles();
+
+    for(U16 addr = 0; addr < LOCKSTEP_RAM_SIZE; addr++)
+    {
+        ram[addr * LOCKSTEP_LANES + lane] = internalRam[addr];
+    }
+}
+
+
+/**
+ * @brief Executes one instruction on every active lane
+ *
+ * @details Lanes are grouped by opcode; each group runs through its lane kernel
+ * under a mask. A group of one lane is the per-lane fallback.
+ */
+void RP2A03Lockstep::step(void)
+{
+    fetch();
+
+    LaneMask pending = activeLanes;
+    while(pending)
+    {
+        U8 op = opcode[__builtin_ctz(pending)];
+
+        // Collect every pending lane that shares this opcode
+        LaneMask group = 0;
+        for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+        {
+            group |= static_cast<LaneMask>(opcode[lane] == op) << lane;
+        }
+        group &= pending;
+
+        executeGroup(op, group);
+        pending &= ~group;
+    }
+}
+
+
+/**
+ * @brief Reads a byte from a lane's view of CPU memory
+ *
+ */
+U8 RP2A03Lockstep::readLane(U32 lane, U16 addr)
+{
+    if(addr < MemoryMap::MEM_IO_BASE_ADDR)
+    {
+        return ram[(addr & 0x07FF) * LOCKSTEP_LANES + lane];
+    }
+    else if(addr >= MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR && cartridge && !cartridge->prgRom.empty())
+    {
+        return cartridge->prgRom[(addr - MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR) % cartridge->prgRom.size()];
+    }
+    else if(buses[lane])
+    {
+        return buses[lane]->readFromBus(addr);
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Reads a 16-bit interrupt vector from a lane's view of CPU memory
+ *
+ * @details Like RP2A03::readVector(), the vector address itself is used while
+ * the lane has nothing to read it from.
+ */
+U16 RP2A03Lockstep::readVector(U32 lane, U16 vector)
+{
+    if(!cartridge && !buses[lane])
+    {
+        return vector;
+    }
+
+    U8 lowByte = readLane(lane, vector);
+    U8 highByte = readLane(lane, vector + 1);
+    return (highByte << 8) | lowByte;
+}
+
+
+/**
+ * @brief Fetches the next opcode byte on every active lane
+ *
+ */
+void RP2A03Lockstep::fetch(void)
+{
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        PC[lane] += (activeLanes >> lane) & 0x01;
+    }
+
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        if((activeLanes >> lane) & 0x01)
+        {
+            opcode[lane] = readLane(lane, PC[lane] + MemoryMap::MEM_PRG_ROM_LOWER_BASE_ADDR);
+        }
+    }
+}
+
+
+/**
+ * @brief Decodes, addresses and executes one opcode for a group of lanes
+ *
+ */
+void RP2A03Lockstep::executeGroup(U8 opCode, LaneMask lanes)
+{
+    static const std::array<Kernel, 256> kernelArray = buildKernelArray();
+
+    const RP2A03::Instr_t& instr = RP2A03::instrArray[opCode];
+
+    applyAddressingMode(instr, lanes);
+    (this->*kernelArray[opCode])(lanes);
+
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        cycles[lane] += ((lanes >> lane) & 0x01) ? instr.cycles : 0;
+    }
+}
+
+
+/**
+ * @brief Computes the operand of every lane in the group
+ *
+ * @details Same reads, in the same order per lane, as RP2A03::applyAddressingMode().
+ */
+void RP2A03Lockstep::applyAddressingMode(const RP2A03::Instr_t& instr, LaneMask lanes)
+{
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        if(!((lanes >> lane) & 0x01))
+        {
+            continue;
+        }
+
+        U16 pc = PC[lane];
+
+        switch(instr.addrMode)
+        {
+            case RP2A03::AddrMode::absin:
+            {
+                U8 lowByte = readLane(lane, pc + 1);
+                U8 highByte = readLane(lane, pc + 2);
+                U16 effectiveAddress = (highByte << 8) | lowByte;
+
+                U8 targetLowByte = readLane(lane, effectiveAddress);
+                U8 targetHighByte = readLane(lane, effectiveAddress + 1);
+                operand[lane] = (targetHighByte << 8) | targetLowByte;
+                break;
+            }
+            case RP2A03::AddrMode::absol:
+            {
+                U8 lowByte = readLane(lane, pc + 1);
+                U8 highByte = readLane(lane, pc + 2);
+                operand[lane] = (highByte << 8) | lowByte;
+                break;
+            }
+            case RP2A03::AddrMode::accum:
+            {
+                operand[lane] = A[lane];
+                break;
+            }
+            case RP2A03::AddrMode::immed:
+            {
+                operand[lane] = readLane(lane, pc + 1);
+                break;
+            }
+            case RP2A03::AddrMode::relat:
+            {
+                int8_t offset = static_cast<int8_t>(readLane(lane, pc + 1));
+                operand[lane] = pc + offset;
+                break;
+            }
+            case RP2A03::AddrMode::xiabs:
+            {
+                U8 lowByte = readLane(lane, pc + 1);
+                U8 highByte = readLane(lane, pc + 2);
+                operand[lane] = ((highByte << 8) | lowByte) + X[lane];
+                break;
+            }
+            case RP2A03::AddrMode::xizpg:
+            {
+                operand[lane] = (readLane(lane, pc + 1) + X[lane]) & 0xFF;
+                break;
+            }
+            case RP2A03::AddrMode::xizpi:
+            {
+                U16 effectiveAddress = (readLane(lane, pc + 1) + X[lane]) & 0xFF;
+                U8 lowByte = readLane(lane, effectiveAddress);
+                U8 highByte = readLane(lane, (effectiveAddress + 1) & 0xFF);
+                operand[lane] = (highByte << 8) | lowByte;
+                break;
+            }
+            case RP2A03::AddrMode::yiabs:
+            {
+                U8 lowByte = readLane(lane, pc + 1);
+                U8 highByte = readLane(lane, pc + 2);
+                operand[lane] = ((highByte << 8) | lowByte) + Y[lane];
+                break;
+            }
+            case RP2A03::AddrMode::yizpg:
+            {
+                operand[lane] = (readLane(lane, pc + 1) + Y[lane]) & 0xFF;
+                break;
+            }
+            case RP2A03::AddrMode::yizpi:
+            {
+                U16 effectiveAddress = (readLane(lane, pc + 1) + Y[lane]) & 0xFF;
+                U8 lowByte = readLane(lane, effectiveAddress);
+                U8 highByte = readLane(lane, (effectiveAddress + 1) & 0xFF);
+                operand[lane] = (highByte << 8) | lowByte;
+                break;
+            }
+            case RP2A03::AddrMode::zpage:
+            {
+                operand[lane] = readLane(lane, pc + 1);
+                break;
+            }
+            default: /* AddrMode::impli, AddrMode::nivim */
+            {
+                operand[lane] = 0;
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Maps every opcode of the instruction vector to its lane kernel
+ *
+ * @details Instructions without a kernel are still stubs in RP2A03 and map to NOP.
+ */
+std::array<RP2A03Lockstep::Kernel, 256> RP2A03Lockstep::buildKernelArray(void)
+{
+    std::array<Kernel, 256> kernels;
+
+    for(U16 op = 0; op < 256; op++)
+    {
+        auto func = RP2A03::instrArray[op].func;
+
+        if(func == &RP2A03::LDA)
+        {
+            kernels[op] = &RP2A03Lockstep::LDA;
+        }
+        else
+        {
+            kernels[op] = &RP2A03Lockstep::NOP;
+        }
+    }
+
+    return kernels;
+}
+
+
+/******************************************************************
+ *                        Lane Kernels                            *
+ ******************************************************************/
+
+#if LOCKSTEP_SIMD
+/**
+ * @brief LDA result write-back with AVX-512 mask registers
+ *
+ * @details Built for AVX-512BW/VL through the target attribute and only called
+ * when the CPU supports it.
+ */
+__attribute__((target("avx512bw,avx512vl")))
+static void loadLanesAVX512(const U8* value, LaneMask lanes, U8* a, U8* status)
+{
+    __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(value));
+    __mmask32 zero = _mm256_cmpeq_epi8_mask(v, _mm256_setzero_si256());
+    __mmask32 negative = _mm256_movepi8_mask(v) & ~zero;
+
+    __m256i flags = _mm256_maskz_mov_epi8(zero & lanes, _mm256_set1_epi8(Flags::ZERO_FLAG));
+    flags = _mm256_mask_mov_epi8(flags, negative & lanes, _mm256_set1_epi8(static_cast<char>(Flags::NEGATIVE_FLAG)));
+
+    __m256i acc = _mm256_mask_mov_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(a)), lanes, v);
+    __m256i st = _mm256_or_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(status)), flags);
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(a), acc);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(status), st);
+}
+
+
+/**
+ * @brief LDA result write-back with AVX2 blends
+ *
+ * @details Built for AVX2 through the target attribute and only called when the
+ * CPU supports it.
+ */
+__attribute__((target("avx2")))
+static void loadLanesAVX2(const U8* value, LaneMask lanes, U8* a, U8* status)
+{
+    alignas(32) std::array<U8, LOCKSTEP_LANES> laneBytes;
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        laneBytes[lane] = ((lanes >> lane) & 0x01) ? 0xFF : 0x00;
+    }
+
+    __m256i m = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneBytes.data()));
+    __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(value));
+    __m256i zero = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+    __m256i negative = _mm256_cmpgt_epi8(_mm256_setzero_si256(), v);
+
+    __m256i flags = _mm256_or_si256(_mm256_and_si256(zero, _mm256_set1_epi8(Flags::ZERO_FLAG)),
+                                    _mm256_andnot_si256(zero, _mm256_and_si256(negative, _mm256_set1_epi8(static_cast<char>(Flags::NEGATIVE_FLAG)))));
+
+    __m256i acc = _mm256_blendv_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(a)), v, m);
+    __m256i st = _mm256_or_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(status)), _mm256_and_si256(flags, m));
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(a), acc);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(status), st);
+}
+#endif
+
+
+/**
+ * @brief Load Accumulator with Memory
+ *
+ * @param lanes Lanes executing the instruction
+ */
+void RP2A03Lockstep::LDA(LaneMask lanes)
+{
+    alignas(32) std::array<U8, LOCKSTEP_LANES> value;
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        value[lane] = static_cast<U8>(operand[lane]);
+    }
+
+#if LOCKSTEP_SIMD
+    if(isa == LockstepISA::avx512)
+    {
+        loadLanesAVX512(value.data(), lanes, A.data(), status.data());
+        return;
+    }
+    else if(isa == LockstepISA::avx2)
+    {
+        loadLanesAVX2(value.data(), lanes, A.data(), status.data());
+        return;
+    }
+#endif
+
+    // Branch-free so the compiler can vectorize it
+    for(U32 lane = 0; lane < LOCKSTEP_LANES; lane++)
+    {
+        U8 m = static_cast<U8>(0 - ((lanes >> lane) & 0x01));
+        U8 v = value[lane];
+        U8 flags = (v == 0) ? Flags::ZERO_FLAG : (v & Flags::NEGATIVE_FLAG);
+
+        A[lane] = (A[lane] & ~m) | (v & m);
+        status[lane] |= flags & m;
+    }
+}
+
+
+/**
+ * @brief Instructions that have no effect yet (stubs in RP2A03)
+ *
+ */
+void RP2A03Lockstep::NOP(LaneMask lanes)
+{
+    (void)lanes;
+}
\ No newline at end of file
@@ -1,16 +1,1099 @@
-#include "../inc/rp2c02.h"
-
-RP2C02::RP2C02()
-{
-    /* Set PPU memory */
-    patternTables   = ((PatternTableMem_Typedef*) PPU_PTRN_TABLE0_BASE_ADDR);
-    nameTables      = ((NameTableMem_Typedef*) PPU_NAME_TABLE0_BASE_ADDR);
-    paletteTables   = ((PaletteMem_Typedef*) PPU_IMAGE_PALETTE_BASE_ADDR);
-    mirrors         = ((MirrorMem_Typedef*) PPU_MIRROR2_BASE_ADDR);
-}
-
-
-RP2C02::~RP2C02()
-{
-
+#include "../inc/rp2c02.h"
+#include "../inc/ppupipeline.h"
+
+
+/**
+ * @brief Reverses the bit order of a pattern plane byte (horizontal flip)
+ *
+ */
+static inline U8 reverseBits(U8 b)
+{
+    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+    b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+    return b;
+}
+
+
+RP2C02::RP2C02()
+{
+    /* Clear PPU memory (CHR RAM until a cartridge with CHR ROM is inserted) */
+    chrRam.assign(0x2000, 0);
+    nameTables.nameTable0.fill(0);
+    nameTables.attrTable0.fill(0);
+    nameTables.nameTable1.fill(0);
+    nameTables.attrTable1.fill(0);
+    nameTables.nameTable2.fill(0);
+    nameTables.attrTable2.fill(0);
+    nameTables.nameTable3.fill(0);
+    nameTables.attrTable3.fill(0);
+    paletteTables.imagePalette.fill(0);
+    paletteTables.spritePalette.fill(0);
+    oam.fill(0);
+
+    // Name tables are tracked as 256-byte state pages
+    static_assert(sizeof(NameTableMem_Typedef) == 16 * STATE_PAGE_SIZE, "name tables must span 16 state pages");
+
+    mirroring = Mirroring::horizontal;
+    pipeline = nullptr;
+    dirtyPages = nullptr;
+    renderInterval = PPU_RENDER_NEVER;
+    outputSuppressed = false;
+    setRenderInterval(1);
+
+    reset();
+}
+
+
+RP2C02::~RP2C02()
+{
+
+}
+
+
+/**
+ * @brief Puts the PPU into its power-up state
+ *
+ */
+void RP2C02::reset(void)
+{
+    if(pipeline)
+    {
+        pipeline->record(PPUCommandType::reset, dotCount, 0, 0);
+    }
+
+    ctrl = 0;
+    mask = 0;
+    status = 0;
+    oamAddr = 0;
+    dataBuffer = 0;
+
+    v = 0;
+    t = 0;
+    fineX = 0;
+    writeToggle = false;
+
+    scanline = 0;
+    dot = 0;
+    frameCount = 0;
+    dotCount = 0;
+    oddFrame = false;
+    renderedFrame = 0;
+
+    lineSpriteCount = 0;
+    lineHasSprite0 = false;
+    lineOverflow = false;
+    sprite0HitDot = 0;
+
+    renderingFrame = (renderInterval != PPU_RENDER_NEVER) && !outputSuppressed && !pipeline;
+}
+
+
+/**
+ * @brief Serializes PPU memory, registers and timing
+ *
+ * @details The render interval, output suppression, frame buffer and cartridge are host side
+ * and not part of the state.
+ */
+void RP2C02::saveState(StateWriter& state)
+{
+    state.put(nameTables);
+    state.put(oam);
+
+    // CHR RAM only exists on boards without CHR ROM
+    if(!chrRam.empty())
+    {
+        state.write(chrRam.data(), chrRam.size());
+    }
+
+    saveRegisters(state);
+}
+
+
+/**
+ * @brief Restores PPU memory, registers and timing
+ *
+ */
+void RP2C02::loadState(StateReader& state)
+{
+    state.get(nameTables);
+    state.get(oam);
+
+    if(!chrRam.empty())
+    {
+        state.read(chrRam.data(), chrRam.size());
+    }
+
+    loadRegisters(state);
+
+    if(dirtyPages)
+    {
+        dirtyPages->markAll();
+    }
+}
+
+
+/**
+ * @brief Serializes everything except the paged memory (name tables, OAM, CHR RAM)
+ *
+ */
+void RP2C02::saveRegisters(StateWriter& state)
+{
+    state.put(paletteTables);
+    state.put(ctrl);
+    state.put(mask);
+    state.put(status);
+    state.put(oamAddr);
+    state.put(dataBuffer);
+    state.put(v);
+    state.put(t);
+    state.put(fineX);
+    state.put(writeToggle);
+    state.put(scanline);
+    state.put(dot);
+    state.putCounter(frameCount);
+    state.putCounter(dotCount);
+    state.put(oddFrame);
+    state.put(lineSprites);
+    state.put(lineSpriteCount);
+    state.put(lineHasSprite0);
+    state.put(lineOverflow);
+    state.put(sprite0HitDot);
+    state.put(mirroring);
+}
+
+
+/**
+ * @brief Restores everything except the paged memory (name tables, OAM, CHR RAM)
+ *
+ */
+void RP2C02::loadRegisters(StateReader& state)
+{
+    state.get(paletteTables);
+    state.get(ctrl);
+    state.get(mask);
+    state.get(status);
+    state.get(oamAddr);
+    state.get(dataBuffer);
+    state.get(v);
+    state.get(t);
+    state.get(fineX);
+    state.get(writeToggle);
+    state.get(scanline);
+    state.get(dot);
+    state.getCounter(frameCount);
+    state.getCounter(dotCount);
+    state.get(oddFrame);
+    state.get(lineSprites);
+    state.get(lineSpriteCount);
+    state.get(lineHasSprite0);
+    state.get(lineOverflow);
+    state.get(sprite0HitDot);
+    state.get(mirroring);
+
+    // Whether pixels are generated is up to this instance's settings, not the saved one's
+    renderingFrame = (renderInterval != PPU_RENDER_NEVER) && ((frameCount % renderInterval) == 0) && !outputSuppressed && !pipeline;
+}
+
+
+/**
+ * @brief Advances the PPU by a single dot
+ *
+ * @details Status flags (vblank, sprite 0 hit, sprite overflow) are raised at the
+ * same dot whether or not pixels are generated for the current frame.
+ */
+void RP2C02::PPU_Cycle(void)
+{
+    bool renderingEnabled = (mask & (PPUFlags::MASK_SHOW_BG | PPUFlags::MASK_SHOW_SPRITES)) != 0;
+
+    if(scanline < PPU_VISIBLE_SCANLINES)
+    {
+        if(dot == 1)
+        {
+            beginScanline();
+        }
+
+        if(sprite0HitDot != 0 && dot == sprite0HitDot)
+        {
+            status |= PPUFlags::STATUS_SPRITE0_HIT;
+        }
+
+        if(renderingEnabled)
+        {
+            if(dot == 256)
+            {
+                incrementY();
+            }
+            else if(dot == 257)
+            {
+                copyHorizontal();
+
+                // Sprite evaluation for the next scanline has finished by now
+                if(lineOverflow)
+                {
+                    status |= PPUFlags::STATUS_SPRITE_OVERFLOW;
+                }
+            }
+        }
+    }
+    else if(scanline == PPU_VBLANK_SCANLINE && dot == 1)
+    {
+        status |= PPUFlags::STATUS_VBLANK;
+        frameCount++;
+
+        if(renderingFrame)
+        {
+            renderedFrame = frameCount;
+        }
+
+        // All visible scanlines are done; hand this frame's log to the render worker
+        if(pipeline)
+        {
+            pipeline->submitFrame(dotCount + 1, !outputSuppressed);
+        }
+    }
+    else if(scanline == PPU_PRERENDER_SCANLINE)
+    {
+        if(dot == 1)
+        {
+            status &= ~(PPUFlags::STATUS_VBLANK | PPUFlags::STATUS_SPRITE0_HIT | PPUFlags::STATUS_SPRITE_OVERFLOW);
+        }
+
+        if(renderingEnabled)
+        {
+            if(dot == 256)
+            {
+                incrementY();
+            }
+            else if(dot == 257)
+            {
+                copyHorizontal();
+            }
+            else if(dot >= 280 && dot <= 304)
+            {
+                copyVertical();
+            }
+
+            // The last dot of the pre-render scanline is skipped on odd frames
+            if(dot == 339 && oddFrame)
+            {
+                dot++;
+            }
+        }
+    }
+
+    // Advance to the next dot
+    dotCount++;
+    dot++;
+    if(dot == PPU_DOTS_PER_SCANLINE)
+    {
+        dot = 0;
+        scanline++;
+
+        if(scanline == PPU_SCANLINES_PER_FRAME)
+        {
+            scanline = 0;
+            oddFrame = !oddFrame;
+
+            // Decide whether this frame generates pixels (the render worker does it when pipelined)
+            renderingFrame = (renderInterval != PPU_RENDER_NEVER) && ((frameCount % renderInterval) == 0) && !outputSuppressed && !pipeline;
+        }
+    }
+}
+
+
+/**
+ * @brief Reads a CPU facing PPU register
+ *
+ * @param addr CPU address (0x2000 - 0x3FFF, mirrored every 8 bytes)
+ *
+ * @return Register value
+ */
+U8 RP2C02::readRegister(U16 addr)
+{
+    U8 data = 0;
+
+    switch(addr & 0x0007)
+    {
+        case PPU_REG_STATUS:
+        {
+            if(pipeline)
+            {
+                pipeline->record(PPUCommandType::registerRead, dotCount, addr, 0);
+            }
+
+            data = status & (PPUFlags::STATUS_VBLANK | PPUFlags::STATUS_SPRITE0_HIT | PPUFlags::STATUS_SPRITE_OVERFLOW);
+
+            // Reading the status register clears vblank and the write toggle
+            status &= ~PPUFlags::STATUS_VBLANK;
+            writeToggle = false;
+            break;
+        }
+        case PPU_REG_OAM_DATA:
+        {
+            data = oam[oamAddr];
+            break;
+        }
+        case PPU_REG_DATA:
+        {
+            if(pipeline)
+            {
+                pipeline->record(PPUCommandType::registerRead, dotCount, addr, 0);
+            }
+
+            /* Reads below the palette are delayed by one read through the internal
+               buffer. Palette reads are immediate, but still refill the buffer with
+               the name table byte "underneath" the palette. */
+
+            if((v & 0x3FFF) < PPU_IMAGE_PALETTE_BASE_ADDR)
+            {
+                data = dataBuffer;
+                dataBuffer = ppuRead(v);
+            }
+            else
+            {
+                data = ppuRead(v);
+                dataBuffer = ppuRead(v - 0x1000);
+            }
+
+            v = (v + ((ctrl & PPUFlags::CTRL_INCREMENT_32) ? 32 : 1)) & 0x7FFF;
+            break;
+        }
+        default: /* Write-only registers */
+        {
+            break;
+        }
+    }
+
+    return data;
+}
+
+
+/**
+ * @brief Writes a CPU facing PPU register
+ *
+ * @param addr CPU address (0x2000 - 0x3FFF, mirrored every 8 bytes)
+ * @param data Value to write
+ */
+void RP2C02::writeRegister(U16 addr, U8 data)
+{
+    if(pipeline)
+    {
+        pipeline->record(PPUCommandType::registerWrite, dotCount, addr, data);
+    }
+
+    switch(addr & 0x0007)
+    {
+        case PPU_REG_CTRL:
+        {
+            ctrl = data;
+            t = (t & 0xF3FF) | ((data & PPUFlags::CTRL_NAMETABLE_SELECT) << 10);
+            break;
+        }
+        case PPU_REG_MASK:
+        {
+            mask = data;
+            break;
+        }
+        case PPU_REG_OAM_ADDR:
+        {
+            oamAddr = data;
+            break;
+        }
+        case PPU_REG_OAM_DATA:
+        {
+            oam[oamAddr++] = data;
+
+            if(dirtyPages)
+            {
+                dirtyPages->mark(STATE_PAGE_OAM);
+            }
+            break;
+        }
+        case PPU_REG_SCROLL:
+        {
+            if(!writeToggle)
+            {
+                fineX = data & 0x07;
+                t = (t & 0xFFE0) | (data >> 3);
+            }
+            else
+            {
+                t = (t & 0x8C1F) | ((data & 0x07) << 12) | ((data & 0xF8) << 2);
+            }
+
+            writeToggle = !writeToggle;
+            break;
+        }
+        case PPU_REG_ADDR:
+        {
+            if(!writeToggle)
+            {
+                t = (t & 0x00FF) | ((data & 0x3F) << 8);
+            }
+            else
+            {
+                t = (t & 0xFF00) | data;
+                v = t;
+            }
+
+            writeToggle = !writeToggle;
+            break;
+        }
+        case PPU_REG_DATA:
+        {
+            ppuWrite(v, data);
+            v = (v + ((ctrl & PPUFlags::CTRL_INCREMENT_32) ? 32 : 1)) & 0x7FFF;
+            break;
+        }
+        default: /* Read-only registers */
+        {
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Number of dots until the PPU has next processed a scanline and dot
+ *
+ * @details Assumes rendering stays as it is; the odd-frame skip of the last
+ * pre-render dot is counted if it lies on the way.
+ */
+U32 RP2C02::dotsUntil(U16 targetScanline, U16 targetDot)
+{
+    U32 here = scanline * PPU_DOTS_PER_SCANLINE + dot;
+    U32 there = targetScanline * PPU_DOTS_PER_SCANLINE + targetDot;
+    U32 skipDot = PPU_PRERENDER_SCANLINE * PPU_DOTS_PER_SCANLINE + 339;
+    U32 frameDots = PPU_SCANLINES_PER_FRAME * PPU_DOTS_PER_SCANLINE;
+
+    if(there >= here)
+    {
+        return there - here + 1;
+    }
+
+    // Wraps into the next frame
+    U32 dots = frameDots - here + there + 1;
+
+    bool renderingEnabled = (mask & (PPUFlags::MASK_SHOW_BG | PPUFlags::MASK_SHOW_SPRITES)) != 0;
+    if(renderingEnabled && oddFrame && here <= skipDot)
+    {
+        dots--;
+    }
+
+    return dots;
+}
+
+
+/**
+ * @brief Copies a 256-byte page into OAM, as OAM DMA does through $2004
+ *
+ * @details The writes start at OAMADDR and wrap around, leaving OAMADDR where
+ * it started.
+ */
+void RP2C02::oamDMA(const U8* data)
+{
+    if(pipeline)
+    {
+        pipeline->recordOAMDMA(dotCount, data);
+    }
+
+    U16 head = static_cast<U16>(oam.size()) - oamAddr;
+    std::copy(data, data + head, oam.begin() + oamAddr);
+    std::copy(data + head, data + oam.size(), oam.begin());
+
+    if(dirtyPages)
+    {
+        dirtyPages->mark(STATE_PAGE_OAM);
+    }
+}
+
+
+/**
+ * @brief Returns the most recent palette index frame
+ *
+ * @details When pipelined, this is the last frame completed by the render worker.
+ * Returns nullptr while the render interval is PPU_RENDER_NEVER.
+ */
+const U8* RP2C02::getFrameBuffer(void)
+{
+    if(pipeline)
+    {
+        return pipeline->getFrameBuffer();
+    }
+
+    return frameBuffer.empty() ? nullptr : frameBuffer.data();
+}
+
+
+/**
+ * @brief Frame number (getFrameCount() at its vblank) of the frame getFrameBuffer() holds
+ *
+ * @details Skipped and suppressed frames leave the buffer, and this number, alone.
+ *
+ * @return 0 if no frame was rendered since reset
+ */
+U64 RP2C02::getFrameBufferFrame(void)
+{
+    if(pipeline)
+    {
+        return pipeline->getPresentedFrame();
+    }
+
+    return renderedFrame;
+}
+
+
+/**
+ * @brief Sets the name table mirroring arrangement
+ *
+ */
+void RP2C02::setMirroring(Mirroring mode)
+{
+    if(pipeline)
+    {
+        pipeline->record(PPUCommandType::mirroring, dotCount, static_cast<U16>(mode), 0);
+    }
+
+    mirroring = mode;
+}
+
+
+/**
+ * @brief Sets the frame skip interval
+ *
+ * @param interval Generate pixels every Nth frame (PPU_RENDER_NEVER: never)
+ */
+void RP2C02::setRenderInterval(U16 interval)
+{
+    if(pipeline)
+    {
+        pipeline->record(PPUCommandType::renderInterval, dotCount, interval, 0);
+    }
+
+    renderInterval = interval;
+
+    // Headless and pipelined instances don't carry the 60 KB frame buffer
+    if(renderInterval == PPU_RENDER_NEVER)
+    {
+        std::vector<U8>().swap(frameBuffer);
+        renderingFrame = false;
+    }
+    else if(frameBuffer.empty() && !pipeline)
+    {
+        frameBuffer.assign(PPU_FRAME_BUFFER_SIZE, 0);
+    }
+}
+
+
+/**
+ * @brief Attaches or detaches a render pipeline
+ *
+ * @details The frame buffer is released while a pipeline is attached, as the
+ * worker's replica generates the pixels. On detach it is reallocated (unless
+ * rendering is off) holding the pipeline's last presented frame, so the
+ * pipeline must have finished.
+ *
+ * @param renderPipeline The pipeline, or nullptr to render synchronously again
+ */
+void RP2C02::attachPipeline(PPURenderPipeline* renderPipeline)
+{
+    if(renderPipeline)
+    {
+        std::vector<U8>().swap(frameBuffer);
+        renderingFrame = false;
+    }
+    else if(pipeline && (renderInterval != PPU_RENDER_NEVER))
+    {
+        const U8* presented = pipeline->getFrameBuffer();
+        frameBuffer.assign(presented, presented + PPU_FRAME_BUFFER_SIZE);
+        renderedFrame = pipeline->getPresentedFrame();
+    }
+
+    pipeline = renderPipeline;
+}
+
+
+/**
+ * @brief Turns pixel generation off or back on, keeping the frame buffer
+ *
+ * @details Suppressing stops the frame in progress at the current scanline;
+ * unsuppressing takes effect at the start of the next frame.
+ */
+void RP2C02::setOutputSuppressed(bool suppressed)
+{
+    outputSuppressed = suppressed;
+
+    if(outputSuppressed)
+    {
+        renderingFrame = false;
+    }
+}
+
+
+/**
+ * @brief Maps a cartridge's CHR ROM into the pattern tables
+ *
+ * @details Boards without CHR ROM get 8 KB of per-instance CHR RAM instead.
+ */
+void RP2C02::insertCartridge(std::shared_ptr<const Cartridge> cart)
+{
+    cartridge = std::move(cart);
+
+    if(cartridge && !cartridge->chrRom.empty())
+    {
+        std::vector<U8>().swap(chrRam);
+    }
+    else
+    {
+        chrRam.assign(0x2000, 0);
+    }
+
+    if(cartridge)
+    {
+        setMirroring(cartridge->mirroring);
+    }
+
+    if(dirtyPages)
+    {
+        dirtyPages->markAll();
+    }
+}
+
+
+/******************************************************************
+ *                        PPU Memory                              *
+ ******************************************************************/
+
+/**
+ * @brief Reads a byte from PPU memory
+ *
+ * @param addr PPU address (0x4000 - 0xFFFF mirror 0x0000 - 0x3FFF)
+ */
+U8 RP2C02::ppuRead(U16 addr)
+{
+    addr &= 0x3FFF;
+
+    if(addr < PPU_NAME_TABLE0_BASE_ADDR)
+    {
+        return chrRam.empty() ? cartridge->chrRom[addr % cartridge->chrRom.size()] : chrRam[addr];
+    }
+    else if(addr < PPU_IMAGE_PALETTE_BASE_ADDR)
+    {
+        return *nameTableEntry(addr);
+    }
+
+    return *paletteEntry(addr);
+}
+
+
+/**
+ * @brief Writes a byte to PPU memory
+ *
+ * @param addr PPU address (0x4000 - 0xFFFF mirror 0x0000 - 0x3FFF)
+ * @param data Value to write
+ */
+void RP2C02::ppuWrite(U16 addr, U8 data)
+{
+    addr &= 0x3FFF;
+
+    if(addr < PPU_NAME_TABLE0_BASE_ADDR)
+    {
+        // CHR ROM is read-only
+        if(!chrRam.empty())
+        {
+            chrRam[addr] = data;
+
+            if(dirtyPages)
+            {
+                dirtyPages->mark(STATE_PAGE_CHR_RAM + (addr >> 8));
+            }
+        }
+    }
+    else if(addr < PPU_IMAGE_PALETTE_BASE_ADDR)
+    {
+        U8* entry = nameTableEntry(addr);
+        *entry = data;
+
+        if(dirtyPages)
+        {
+            dirtyPages->mark(STATE_PAGE_NAMETABLE + ((entry - getNameTables()) >> 8));
+        }
+    }
+    else
+    {
+        *paletteEntry(addr) = data;
+    }
+}
+
+
+/**
+ * @brief Resolves a name table address according to the mirroring arrangement
+ *
+ * @param addr PPU address (0x2000 - 0x3EFF; 0x3000 - 0x3EFF mirror 0x2000 - 0x2EFF)
+ */
+U8* RP2C02::nameTableEntry(U16 addr)
+{
+    U16 offset = addr & 0x03FF;
+    U8 table = (addr >> 10) & 0x03;
+
+    switch(mirroring)
+    {
+        case Mirroring::vertical:   table &= 0x01; break;
+        case Mirroring::horizontal: table >>= 1; break;
+        default:                    break;
+    }
+
+    switch(table)
+    {
+        case 0:  return (offset < 960) ? &nameTables.nameTable0[offset] : &nameTables.attrTable0[offset - 960];
+        case 1:  return (offset < 960) ? &nameTables.nameTable1[offset] : &nameTables.attrTable1[offset - 960];
+        case 2:  return (offset < 960) ? &nameTables.nameTable2[offset] : &nameTables.attrTable2[offset - 960];
+        default: return (offset < 960) ? &nameTables.nameTable3[offset] : &nameTables.attrTable3[offset - 960];
+    }
+}
+
+
+/**
+ * @brief Resolves a palette address
+ *
+ * @details 0x3F20 - 0x3FFF mirror 0x3F00 - 0x3F1F, and the sprite palette
+ * backdrop entries (0x3F10/14/18/1C) mirror the image palette entries.
+ */
+U8* RP2C02::paletteEntry(U16 addr)
+{
+    U8 index = addr & 0x1F;
+
+    if((index & 0x13) == 0x10)
+    {
+        index &= 0x0F;
+    }
+
+    return (index < 16) ? &paletteTables.imagePalette[index] : &paletteTables.spritePalette[index - 16];
+}
+
+
+/******************************************************************
+ *                        Rendering                               *
+ ******************************************************************/
+
+/**
+ * @brief Prepares a visible scanline
+ *
+ * @details Sprite evaluation and sprite 0 hit detection always run, pixel
+ * generation only runs on frames selected by the render interval.
+ */
+void RP2C02::beginScanline(void)
+{
+    lineSpriteCount = 0;
+    lineHasSprite0 = false;
+    lineOverflow = false;
+    sprite0HitDot = 0;
+
+    if((mask & (PPUFlags::MASK_SHOW_BG | PPUFlags::MASK_SHOW_SPRITES)) != 0)
+    {
+        evaluateSprites();
+
+        if(lineHasSprite0 && !(status & PPUFlags::STATUS_SPRITE0_HIT))
+        {
+            sprite0HitDot = findSprite0Hit();
+        }
+    }
+
+    if(renderingFrame)
+    {
+        renderScanline();
+    }
+}
+
+
+/**
+ * @brief Selects the (up to 8) sprites that cover the current scanline
+ *
+ * @details The 2C02 evaluates sprites one scanline ahead, so the overflow found
+ * during this scanline is the next scanline's.
+ */
+void RP2C02::evaluateSprites(void)
+{
+    int height = (ctrl & PPUFlags::CTRL_SPRITE_SIZE) ? 16 : 8;
+    U8 nextLineCount = 0;
+
+    for(U8 i = 0; i < 64; i++)
+    {
+        // Sprite data is delayed by one scanline
+        int row = static_cast<int>(scanline) - static_cast<int>(oam[i * 4]) - 1;
+
+        if(row >= 0 && row < height && lineSpriteCount < 8)
+        {
+            if(i == 0)
+            {
+                lineHasSprite0 = true;
+            }
+
+            lineSprites[lineSpriteCount++] = i;
+        }
+
+        if(row + 1 >= 0 && row + 1 < height)
+        {
+            nextLineCount++;
+        }
+    }
+
+    lineOverflow = (nextLineCount > 8);
+}
+
+
+/**
+ * @brief Finds the first opaque sprite 0 pixel overlapping an opaque background pixel
+ *
+ * @return Dot at which sprite 0 hit is raised, 0 if there is no hit on this scanline
+ */
+U16 RP2C02::findSprite0Hit(void)
+{
+    if((mask & (PPUFlags::MASK_SHOW_BG | PPUFlags::MASK_SHOW_SPRITES)) != (PPUFlags::MASK_SHOW_BG | PPUFlags::MASK_SHOW_SPRITES))
+    {
+        return 0;
+    }
+
+    bool leftClipped = (mask & (PPUFlags::MASK_BG_LEFT | PPUFlags::MASK_SPRITE_LEFT)) != (PPUFlags::MASK_BG_LEFT | PPUFlags::MASK_SPRITE_LEFT);
+
+    U8 spriteLow, spriteHigh;
+    fetchSpriteRow(0, &spriteLow, &spriteHigh);
+    U8 spriteX = oam[3];
+
+    for(U16 i = 0; i < 8; i++)
+    {
+        U16 x = spriteX + i;
+
+        // No hit at x = 255
+        if(x >= 255)
+        {
+            break;
+        }
+
+        if((x < 8 && leftClipped) || !(((spriteLow | spriteHigh) << i) & 0x80))
+        {
+            continue;
+        }
+
+        U16 fine = fineX + x;
+        U8 bgLow, bgHigh, bgPalette;
+        fetchBackgroundTile(fine >> 3, &bgLow, &bgHigh, &bgPalette);
+
+        if(((bgLow | bgHigh) << (fine & 0x07)) & 0x80)
+        {
+            return x + 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Generates the palette indices for the current scanline
+ *
+ */
+void RP2C02::renderScanline(void)
+{
+    U8* line = &frameBuffer[scanline * PPU_SCREEN_WIDTH];
+    U8 greyscale = (mask & PPUFlags::MASK_GREYSCALE) ? 0x30 : 0x3F;
+
+    // Background: 4-bit palette entry per pixel (0: transparent)
+    std::array<U8, PPU_SCREEN_WIDTH> bgPixels = {};
+    if(mask & PPUFlags::MASK_SHOW_BG)
+    {
+        for(U16 column = 0; column <= 32; column++)
+        {
+            U8 low, high, palette;
+            fetchBackgroundTile(column, &low, &high, &palette);
+
+            for(U16 bit = 0; bit < 8; bit++)
+            {
+                int x = column * 8 + bit - fineX;
+                if(x < 0 || x >= PPU_SCREEN_WIDTH)
+                {
+                    continue;
+                }
+
+                U8 pixel = ((low >> (7 - bit)) & 0x01) | (((high >> (7 - bit)) & 0x01) << 1);
+                bgPixels[x] = pixel ? ((palette << 2) | pixel) : 0;
+            }
+        }
+
+        if(!(mask & PPUFlags::MASK_BG_LEFT))
+        {
+            std::fill(bgPixels.begin(), bgPixels.begin() + 8, 0);
+        }
+    }
+
+    // Sprites: 5-bit palette entry per pixel (0: transparent), BIT7 set when behind the background
+    std::array<U8, PPU_SCREEN_WIDTH> spritePixels = {};
+    if(mask & PPUFlags::MASK_SHOW_SPRITES)
+    {
+        U16 firstX = (mask & PPUFlags::MASK_SPRITE_LEFT) ? 0 : 8;
+
+        // Lower OAM indices have priority, so draw them last
+        for(int i = lineSpriteCount - 1; i >= 0; i--)
+        {
+            U8 low, high;
+            U8 attr = fetchSpriteRow(lineSprites[i], &low, &high);
+            U16 spriteX = oam[lineSprites[i] * 4 + 3];
+
+            for(U16 bit = 0; bit < 8; bit++)
+            {
+                U16 x = spriteX + bit;
+                if(x >= PPU_SCREEN_WIDTH)
+                {
+                    break;
+                }
+
+                U8 pixel = ((low >> (7 - bit)) & 0x01) | (((high >> (7 - bit)) & 0x01) << 1);
+                if(pixel && x >= firstX)
+                {
+                    spritePixels[x] = 0x10 | ((attr & PPUFlags::SPRITE_PALETTE) << 2) | pixel | ((attr & PPUFlags::SPRITE_BEHIND_BG) ? 0x80 : 0);
+                }
+            }
+        }
+    }
+
+    // Priority multiplexer
+    for(U16 x = 0; x < PPU_SCREEN_WIDTH; x++)
+    {
+        U8 bg = bgPixels[x];
+        U8 sprite = spritePixels[x];
+        U8 entry = (sprite && (!bg || !(sprite & 0x80))) ? (sprite & 0x1F) : bg;
+
+        line[x] = *paletteEntry(PPU_IMAGE_PALETTE_BASE_ADDR + entry) & greyscale;
+    }
+
+    // Emphasis is applied by the output stage
+    frameBuffer[PPU_EMPHASIS_OFFSET + scanline] = (mask & PPUFlags::MASK_EMPHASIS) >> 5;
+}
+
+
+/**
+ * @brief Fetches the pattern planes and palette of a background tile on the current scanline
+ *
+ * @param column Tile column relative to the coarse X scroll (0 - 32)
+ */
+void RP2C02::fetchBackgroundTile(U16 column, U8* lowPlane, U8* highPlane, U8* palette)
+{
+    U16 coarseX = (v & 0x001F) + column;
+    U16 table = (v >> 10) & 0x03;
+
+    // Wrap into the horizontally adjacent name table
+    if(coarseX >= 32)
+    {
+        coarseX -= 32;
+        table ^= 0x01;
+    }
+
+    U16 coarseY = (v >> 5) & 0x001F;
+    U16 fineY = (v >> 12) & 0x0007;
+    U16 base = PPU_NAME_TABLE0_BASE_ADDR | (table << 10);
+
+    U8 tile = ppuRead(base | (coarseY << 5) | coarseX);
+    U8 attr = ppuRead(base | 0x03C0 | ((coarseY >> 2) << 3) | (coarseX >> 2));
+    *palette = (attr >> (((coarseY & 0x02) << 1) | (coarseX & 0x02))) & 0x03;
+
+    U16 patternAddr = ((ctrl & PPUFlags::CTRL_BG_TABLE) ? PPU_PTRN_TABLE1_BASE_ADDR : PPU_PTRN_TABLE0_BASE_ADDR) + tile * 16 + fineY;
+    *lowPlane = ppuRead(patternAddr);
+    *highPlane = ppuRead(patternAddr + 8);
+}
+
+
+/**
+ * @brief Fetches the pattern planes of a sprite on the current scanline
+ *
+ * @details Horizontal flipping is applied, so BIT7 is always the leftmost pixel.
+ *
+ * @return Sprite attribute byte
+ */
+U8 RP2C02::fetchSpriteRow(U8 oamIndex, U8* lowPlane, U8* highPlane)
+{
+    U8 tile = oam[oamIndex * 4 + 1];
+    U8 attr = oam[oamIndex * 4 + 2];
+    U16 height = (ctrl & PPUFlags::CTRL_SPRITE_SIZE) ? 16 : 8;
+    U16 row = scanline - oam[oamIndex * 4] - 1;
+
+    if(attr & PPUFlags::SPRITE_FLIP_VERTICAL)
+    {
+        row = height - 1 - row;
+    }
+
+    U16 patternAddr;
+    if(height == 16)
+    {
+        // 8x16 sprites select the pattern table with BIT0 of the tile index
+        patternAddr = ((tile & 0x01) ? PPU_PTRN_TABLE1_BASE_ADDR : PPU_PTRN_TABLE0_BASE_ADDR) + ((tile & 0xFE) + (row >> 3)) * 16 + (row & 0x07);
+    }
+    else
+    {
+        patternAddr = ((ctrl & PPUFlags::CTRL_SPRITE_TABLE) ? PPU_PTRN_TABLE1_BASE_ADDR : PPU_PTRN_TABLE0_BASE_ADDR) + tile * 16 + row;
+    }
+
+    *lowPlane = ppuRead(patternAddr);
+    *highPlane = ppuRead(patternAddr + 8);
+
+    if(attr & PPUFlags::SPRITE_FLIP_HORIZONTAL)
+    {
+        *lowPlane = reverseBits(*lowPlane);
+        *highPlane = reverseBits(*highPlane);
+    }
+
+    return attr;
+}
+
+
+/**
+ * @brief Increments the fine/coarse Y scroll in v (dot 256)
+ *
+ */
+void RP2C02::incrementY(void)
+{
+    if((v & 0x7000) != 0x7000)
+    {
+        v += 0x1000;
+        return;
+    }
+
+    v &= ~0x7000;
+    U16 coarseY = (v & 0x03E0) >> 5;
+
+    if(coarseY == 29)
+    {
+        coarseY = 0;
+        v ^= 0x0800;
+    }
+    else if(coarseY == 31)
+    {
+        coarseY = 0;
+    }
+    else
+    {
+        coarseY++;
+    }
+
+    v = (v & ~0x03E0) | (coarseY << 5);
+}
+
+
+/**
+ * @brief Copies the horizontal scroll bits from t to v (dot 257)
+ *
+ */
+void RP2C02::copyHorizontal(void)
+{
+    v = (v & ~0x041F) | (t & 0x041F);
+}
+
+
+/**
+ * @brief Copies the vertical scroll bits from t to v (pre-render dots 280 - 304)
+ *
+ */
+void RP2C02::copyVertical(void)
+{
+    v = (v & ~0x7BE0) | (t & 0x7BE0);
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "../inc/statepublisher.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHM_SUPPORTED
+#endif
+
+
+/**
+ * @brief Creates the segment, or attaches to an existing one of the same name
+ *
+ * @details An existing segment keeps its sequence number: subscribers that are
+ * mapped already must never see it go backwards (or a snapshot it last named
+ * change under the same number). Only a publisher that created the segment
+ * unlinks it.
+ */
+StatePublisher::StatePublisher(const std::string& segmentName) : name(segmentName), shared(nullptr), owner(false)
+{
+#ifdef SHM_SUPPORTED
+    bool created = true;
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0 && errno == EEXIST)
+    {
+        created = false;
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+    }
+
+    if(fd < 0)
+    {
+        return;
+    }
+
+    // Growing an existing segment zero-fills the new bytes; it is never shrunk
+    struct stat info;
+    if(fstat(fd, &info) == 0 && (info.st_size >= (off_t)sizeof(SharedState) || ftruncate(fd, sizeof(SharedState)) == 0))
+    {
+        void* mapping = mmap(nullptr, sizeof(SharedState), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(mapping != MAP_FAILED)
+        {
+            shared = static_cast<SharedState*>(mapping);
+        }
+    }
+
+    close(fd);
+
+    if(created && !shared)
+    {
+        // Don't leave behind a segment nobody publishes to
+        shm_unlink(name.c_str());
+    }
+
+    owner = created && (shared != nullptr);
+
+    if(shared && created)
+    {
+        shared->sequence.store(0, std::memory_order_relaxed);
+        shared->magic = SHM_STATE_MAGIC;
+        shared->version = SHM_STATE_VERSION;
+        shared->frameValid = 0;
+    }
+    else if(shared)
+    {
+        // Inside a write of ours, so subscribers skip the header update
+        U32 sequence = shared->sequence.load(std::memory_order_relaxed) | 0x01;
+        shared->sequence.store(sequence, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        shared->magic = SHM_STATE_MAGIC;
+        shared->version = SHM_STATE_VERSION;
+        shared->frameValid = 0;
+
+        shared->sequence.store(sequence + 1, std::memory_order_release);
+    }
+#endif
+}
+
+
+StatePublisher::~StatePublisher()
+{
+#ifdef SHM_SUPPORTED
+    if(shared)
+    {
+        munmap(shared, sizeof(SharedState));
+    }
+
+    if(owner)
+    {
+        shm_unlink(name.c_str());
+    }
+#endif
+}
+
+
+/**
+ * @brief Writes a snapshot under the seqlock
+ *
+ * @details Readers that overlap the write see an odd or changed sequence
+ * number and retry, so the emulator never waits for them.
+ */
+void StatePublisher::publish(RP2A03& cpu, NESMemory& memory, RP2C02& ppu)
+{
+    if(!shared)
+    {
+        return;
+    }
+
+    // Odd while writing; a segment left odd by a publisher that died mid-write stays odd
+    U32 sequence = shared->sequence.load(std::memory_order_relaxed) | 0x01;
+    shared->sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    shared->frameCount = ppu.getFrameCount();
+    shared->cycles = cpu.getCycles();
+    shared->PC = cpu.getPC();
+    shared->SP = cpu.getSP();
+    shared->A = cpu.getA();
+    shared->X = cpu.getX();
+    shared->Y = cpu.getY();
+    shared->status = cpu.getStatus();
+    std::memcpy(shared->ram, memory.getRAM(), SHM_RAM_SIZE);
+
+    // Skipped frames republish the last rendered one, under its own frame number
+    const U8* frame = ppu.getFrameBuffer();
+    U64 frameNumber = ppu.getFrameBufferFrame();
+    if(frame && frameNumber)
+    {
+        std::memcpy(shared->frameBuffer, frame, sizeof(shared->frameBuffer));
+    }
+    shared->frameValid = (frame != nullptr) && (frameNumber != 0);
+    shared->frameNumber = frameNumber;
+
+    shared->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+
+StateSubscriber::StateSubscriber(const std::string& segmentName) : shared(nullptr)
+{
+#ifdef SHM_SUPPORTED
+    int fd = shm_open(segmentName.c_str(), O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return;
+    }
+
+    void* mapping = mmap(nullptr, sizeof(SharedState), PROT_READ, MAP_SHARED, fd, 0);
+    if(mapping != MAP_FAILED)
+    {
+        shared = static_cast<const SharedState*>(mapping);
+    }
+
+    close(fd);
+#else
+    (void)segmentName;
+#endif
+}
+
+
+StateSubscriber::~StateSubscriber()
+{
+#ifdef SHM_SUPPORTED
+    if(shared)
+    {
+        munmap(const_cast<SharedState*>(shared), sizeof(SharedState));
+    }
+#endif
+}
+
+
+/**
+ * @brief Copies the latest consistent snapshot
+ *
+ * @details Never blocks the publisher; gives up after SHM_READ_RETRIES torn reads.
+ *
+ * @return false if no consistent snapshot could be read
+ */
+bool StateSubscriber::read(StateSnapshot* snapshot)
+{
+    if(!shared || shared->magic != SHM_STATE_MAGIC || shared->version != SHM_STATE_VERSION)
+    {
+        return false;
+    }
+
+    for(U32 attempt = 0; attempt < SHM_READ_RETRIES; attempt++)
+    {
+        U32 before = shared->sequence.load(std::memory_order_acquire);
+        if(before & 0x01)
+        {
+            continue;
+        }
+
+        snapshot->frameValid = shared->frameValid;
+        snapshot->frameCount = shared->frameCount;
+        snapshot->frameNumber = shared->frameNumber;
+        snapshot->cycles = shared->cycles;
+        snapshot->PC = shared->PC;
+        snapshot->SP = shared->SP;
+        snapshot->A = shared->A;
+        snapshot->X = shared->X;
+        snapshot->Y = shared->Y;
+        snapshot->status = shared->status;
+        std::memcpy(snapshot->ram, shared->ram, SHM_RAM_SIZE);
+        std::memcpy(snapshot->frameBuffer, shared->frameBuffer, sizeof(snapshot->frameBuffer));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(shared->sequence.load(std::memory_order_relaxed) == before)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
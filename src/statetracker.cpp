@@ -0,0 +1,246 @@
+#include "../inc/statetracker.h"
+
+#include <cstring>
+
+
+/**
+ * @brief 64-bit finalizer (MurmurHash3 fmix64)
+ *
+ */
+static inline U64 mix64(U64 h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+
+/**
+ * @brief Hashes a byte range, eight bytes per round
+ *
+ */
+static U64 hashBytes(const U8* data, size_t size, U64 seed)
+{
+    U64 h = mix64(seed + size);
+    size_t i = 0;
+
+    for(; i + 8 <= size; i += 8)
+    {
+        U64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+
+        h ^= word * 0x87C37B91114253D5ULL;
+        h = ((h << 31) | (h >> 33)) * 0x4CF5AD432745937FULL;
+    }
+
+    for(; i < size; i++)
+    {
+        h = (h ^ data[i]) * 0x100000001B3ULL;
+    }
+
+    return mix64(h);
+}
+
+
+StateTracker::StateTracker(NES& nes) : console(nes)
+{
+    pageHashes.fill(0);
+    combinedPageHash = 0;
+    deltaPages.clear();
+
+    // Start from a full rehash and a full first delta
+    console.getBus()->markAllDirty();
+}
+
+StateTracker::~StateTracker(){}
+
+
+/**
+ * @brief Rehashes the pages written since the last collection
+ *
+ * @details Pages are combined with XOR, so a page's old hash can be replaced
+ * without touching the others.
+ */
+void StateTracker::collect(void)
+{
+    DirtyPages dirty = console.getBus()->collectDirtyPages();
+
+    dirty.forEach([this](U16 page)
+    {
+        U64 pageHash = hashPage(page);
+        combinedPageHash ^= pageHashes[page] ^ pageHash;
+        pageHashes[page] = pageHash;
+    });
+
+    deltaPages |= dirty;
+}
+
+
+/**
+ * @brief Hashes one state page, seeded with its index so equal pages at different places differ
+ *
+ * @return 0 for pages that don't exist on this board
+ */
+U64 StateTracker::hashPage(U16 page)
+{
+    const U8* data = console.getBus()->getStatePage(page);
+    return data ? hashBytes(data, STATE_PAGE_SIZE, page + 1) : 0;
+}
+
+
+/**
+ * @brief Serializes the CPU and the bus registers into the scratch buffer
+ *
+ * @param fingerprint Leave out the timebase (see StateWriter) for hashing
+ *
+ * @return Size of the registers in bytes
+ */
+size_t StateTracker::saveRegisters(bool fingerprint)
+{
+    for(;;)
+    {
+        StateWriter state(registers.data(), registers.size());
+
+        if(fingerprint)
+        {
+            U64 cycles = console.getCPU()->getCycles();
+            state.setFingerprint(cycles);
+
+            // OAM DMA takes a cycle longer on odd cycles, so the parity is still state
+            state.put(static_cast<U8>(cycles & 0x01));
+        }
+
+        console.getCPU()->saveState(state);
+        console.getBus()->saveRegisters(state);
+
+        if(!state.overflowed())
+        {
+            return state.size();
+        }
+
+        registers.resize(state.size());
+    }
+}
+
+
+/**
+ * @brief Returns a 64-bit hash of the full machine state
+ *
+ */
+U64 StateTracker::hash(void)
+{
+    collect();
+
+    size_t size = saveRegisters(true);
+    return combinedPageHash ^ hashBytes(registers.data(), size, 0);
+}
+
+
+/**
+ * @brief Serializes the registers and the pages written since the previous delta
+ *
+ * @param buffer Destination, or nullptr to only compute the size
+ * @param size Size of the destination in bytes
+ *
+ * @return Size of the delta in bytes (larger than size if it didn't fit; the
+ * pages are then kept for the next attempt)
+ */
+size_t StateTracker::saveDelta(U8* buffer, size_t size)
+{
+    collect();
+
+    Bus* bus = console.getBus();
+    U16 count = 0;
+    deltaPages.forEach([&](U16 page)
+    {
+        count += (bus->getStatePage(page) != nullptr);
+    });
+
+    StateWriter state(buffer, size);
+    state.put(STATEDELTA_MAGIC);
+    state.put(SAVESTATE_VERSION);
+    console.getCPU()->saveState(state);
+    bus->saveRegisters(state);
+    state.put(count);
+
+    deltaPages.forEach([&](U16 page)
+    {
+        const U8* data = bus->getStatePage(page);
+        if(data)
+        {
+            state.put(page);
+            state.write(data, STATE_PAGE_SIZE);
+        }
+    });
+
+    if(buffer && !state.overflowed())
+    {
+        deltaPages.clear();
+    }
+
+    return state.size();
+}
+
+
+/**
+ * @brief Applies a delta written by saveDelta()
+ *
+ * @return false if the buffer doesn't hold a delta for this console and cartridge
+ */
+bool StateTracker::loadDelta(const U8* buffer, size_t size)
+{
+    Bus* bus = console.getBus();
+    size_t registersSize = saveRegisters(false);
+    size_t headerSize = sizeof(U32) * 2 + registersSize + sizeof(U16);
+    if(!buffer || size < headerSize)
+    {
+        return false;
+    }
+
+    StateReader state(buffer, size);
+
+    U32 magic = 0;
+    U32 version = 0;
+    state.get(magic);
+    state.get(version);
+    if(magic != STATEDELTA_MAGIC || version != SAVESTATE_VERSION)
+    {
+        return false;
+    }
+
+    // Validate the page list before touching the console
+    U16 count = 0;
+    std::memcpy(&count, buffer + headerSize - sizeof(U16), sizeof(count));
+    if(size != headerSize + count * (sizeof(U16) + STATE_PAGE_SIZE))
+    {
+        return false;
+    }
+
+    for(U16 i = 0; i < count; i++)
+    {
+        U16 page = 0;
+        std::memcpy(&page, buffer + headerSize + i * (sizeof(U16) + STATE_PAGE_SIZE), sizeof(page));
+        if(page >= STATE_PAGE_COUNT || !bus->getStatePage(page))
+        {
+            return false;
+        }
+    }
+
+    console.getCPU()->loadState(state);
+    bus->loadRegisters(state);
+    state.get(count);
+
+    for(U16 i = 0; i < count; i++)
+    {
+        U16 page = 0;
+        state.get(page);
+        state.read(bus->getStatePage(page), STATE_PAGE_SIZE);
+        bus->markDirty(page);
+    }
+
+    bus->syncRenderPipeline();
+    return true;
+}
\ No newline at end of file
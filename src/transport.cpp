@@ -0,0 +1,180 @@
+#include "../inc/transport.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define UDP_SUPPORTED
+#endif
+
+
+/******************************************************************
+ *                        UDP Transport                           *
+ ******************************************************************/
+
+UDPTransport::UDPTransport(U16 localPort, const std::string& remoteHost, U16 remotePort) : socketHandle(-1)
+{
+    remoteAddress.fill(0);
+
+#ifdef UDP_SUPPORTED
+    static_assert(sizeof(sockaddr_in) <= sizeof(remoteAddress), "remote address storage too small");
+
+    sockaddr_in remote;
+    std::memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(remotePort);
+    if(inet_pton(AF_INET, remoteHost.c_str(), &remote.sin_addr) != 1)
+    {
+        return;
+    }
+    std::memcpy(remoteAddress.data(), &remote, sizeof(remote));
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0)
+    {
+        return;
+    }
+
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(localPort);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    // Polled every frame, so the socket must never block
+    if(bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+       fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    socketHandle = fd;
+#else
+    (void)localPort;
+    (void)remoteHost;
+    (void)remotePort;
+#endif
+}
+
+
+UDPTransport::~UDPTransport()
+{
+#ifdef UDP_SUPPORTED
+    if(socketHandle >= 0)
+    {
+        close(socketHandle);
+    }
+#endif
+}
+
+
+bool UDPTransport::send(const U8* data, size_t size)
+{
+#ifdef UDP_SUPPORTED
+    if(socketHandle < 0)
+    {
+        return false;
+    }
+
+    return sendto(socketHandle, data, size, 0, reinterpret_cast<const sockaddr*>(remoteAddress.data()), sizeof(sockaddr_in)) == static_cast<ssize_t>(size);
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+
+size_t UDPTransport::receive(U8* buffer, size_t size)
+{
+#ifdef UDP_SUPPORTED
+    if(socketHandle < 0)
+    {
+        return 0;
+    }
+
+    ssize_t received = recv(socketHandle, buffer, size, 0);
+    return (received > 0) ? static_cast<size_t>(received) : 0;
+#else
+    (void)buffer;
+    (void)size;
+    return 0;
+#endif
+}
+
+
+/******************************************************************
+ *                        Fake Link                               *
+ ******************************************************************/
+
+FakeLink::FakeLink(U32 latencyMs, U32 jitterMs, double loss, U32 seed) :
+    latency(latencyMs), jitter(jitterMs), lossRate(loss),
+    endpoints{{Endpoint(this, 0), Endpoint(this, 1)}}, random(seed)
+{
+
+}
+
+
+FakeLink::~FakeLink()
+{
+
+}
+
+
+/**
+ * @brief Puts a packet in flight to the given side, unless it is dropped
+ *
+ */
+bool FakeLink::post(U8 side, const U8* data, size_t size)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(std::uniform_real_distribution<double>(0.0, 1.0)(random) < lossRate)
+    {
+        // Lost packets look sent to the sender, as with UDP
+        return true;
+    }
+
+    U32 delay = latency + (jitter ? std::uniform_int_distribution<U32>(0, jitter)(random) : 0);
+
+    Packet packet;
+    packet.deliverAt = Clock::now() + std::chrono::milliseconds(delay);
+    packet.data.assign(data, data + size);
+    queues[side].push_back(std::move(packet));
+
+    return true;
+}
+
+
+/**
+ * @brief Hands out the earliest packet whose delivery time has passed
+ *
+ */
+size_t FakeLink::fetch(U8 side, U8* buffer, size_t size)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::vector<Packet>& queue = queues[side];
+    auto next = std::min_element(queue.begin(), queue.end(), [](const Packet& a, const Packet& b)
+    {
+        return a.deliverAt < b.deliverAt;
+    });
+
+    if(next == queue.end() || next->deliverAt > Clock::now())
+    {
+        return 0;
+    }
+
+    // Oversized packets are truncated, like a short datagram read
+    size_t length = std::min(size, next->data.size());
+    std::memcpy(buffer, next->data.data(), length);
+    queue.erase(next);
+
+    return length;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+/* C API test: compiled as C and linked against the shared library, so it only
+   sees what inc/nesemu.h exports */
+
+#include "../inc/nesemu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* C API Test Definitions */
+#define CAPI_TEST_PRG_BANKS                 2
+#define CAPI_TEST_CHR_BANKS                 1
+#define CAPI_TEST_ROM_SIZE                  (16 + CAPI_TEST_PRG_BANKS * 0x4000 + CAPI_TEST_CHR_BANKS * 0x2000)
+#define CAPI_TEST_FRAMES                    5
+
+
+/* Failed CHECK()s of this test program */
+static unsigned testFailures = 0;
+
+/* Records a failure (with its location) instead of stopping, so every check runs */
+#define CHECK(condition) \
+    do \
+    { \
+        if(!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            testFailures++; \
+        } \
+    } while(0)
+
+
+/**
+ * @brief Mapper 0 iNES image with pseudo-random PRG and CHR ROM (as makeTestROM in testing.h)
+ *
+ */
+static void makeTestROM(uint8_t* rom, uint32_t seed)
+{
+    size_t i;
+
+    memset(rom, 0, 16);
+    rom[0] = 'N';
+    rom[1] = 'E';
+    rom[2] = 'S';
+    rom[3] = 0x1A;
+    rom[4] = CAPI_TEST_PRG_BANKS;
+    rom[5] = CAPI_TEST_CHR_BANKS;
+
+    for(i = 16; i < CAPI_TEST_ROM_SIZE; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        rom[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+
+/**
+ * @brief Create, load, step, convert, save/load, hash, clone and destroy through the C ABI
+ *
+ */
+static void checkLifecycle(void)
+{
+    static uint8_t rom[CAPI_TEST_ROM_SIZE];
+    static uint32_t pixels[NESEMU_SCREEN_WIDTH * NESEMU_SCREEN_HEIGHT];
+    nes_t* nes;
+    nes_t* clone;
+    void* state;
+    size_t stateSize;
+    uint64_t hash;
+
+    makeTestROM(rom, 30);
+
+    nes = nes_create();
+    CHECK(nes != NULL);
+    if(!nes)
+    {
+        return;
+    }
+
+    /* Malformed images are rejected */
+    CHECK(nes_load_rom(nes, rom, 8) == -1);
+    CHECK(nes_load_rom_file(nes, NULL) == -1);
+    CHECK(nes_load_rom(nes, rom, sizeof(rom)) == 0);
+
+    nes_set_input(nes, 0, NESEMU_BUTTON_A | NESEMU_BUTTON_START);
+    nes_step_frames(nes, CAPI_TEST_FRAMES);
+    CHECK(nes_frame_count(nes) == CAPI_TEST_FRAMES);
+
+    /* Zero-copy views and conversion */
+    CHECK(nes_ram(nes) != NULL);
+    CHECK(nes_framebuffer(nes) != NULL);
+    CHECK(nes_convert_frame(nes, pixels, NESEMU_SCREEN_WIDTH * 4, NESEMU_FORMAT_RGBA8888) == 0);
+    CHECK(nes_convert_frame(nes, pixels, NESEMU_SCREEN_WIDTH * 2, NESEMU_FORMAT_RGB565) == 0);
+    CHECK(nes_convert_frame(nes, pixels, NESEMU_SCREEN_WIDTH * 4, 3) == -1);
+
+    /* Save, run on, load: back to the same hash */
+    stateSize = nes_state_size(nes);
+    CHECK(stateSize > NESEMU_RAM_SIZE);
+    state = malloc(stateSize);
+    CHECK(nes_save_state(nes, state, stateSize) == 0);
+    CHECK(nes_save_state(nes, state, stateSize - 1) == -1);
+    hash = nes_state_hash(nes);
+
+    nes_ram(nes)[0x10] ^= 0xFF;
+    nes_mark_dirty(nes);
+    nes_step_frame(nes);
+    CHECK(nes_state_hash(nes) != hash);
+
+    CHECK(nes_load_state(nes, state, stateSize) == 0);
+    CHECK(nes_state_hash(nes) == hash);
+    CHECK(nes_load_state(nes, state, stateSize - 1) == -1);
+    free(state);
+
+    /* A clone runs on to the same state */
+    clone = nes_clone(nes);
+    CHECK(clone != NULL);
+    CHECK(nes_state_hash(clone) == hash);
+    nes_step_frames(nes, 2);
+    nes_step_frames(clone, 2);
+    CHECK(nes_state_hash(clone) == nes_state_hash(nes));
+    nes_destroy(clone);
+
+    /* Render intervals wider than 16 bits are rejected, not wrapped to never */
+    CHECK(nes_set_render_interval(nes, 65536) == -1);
+    nes_step_frame(nes);
+    CHECK(nes_framebuffer(nes) != NULL);
+    CHECK(nes_set_render_interval(nes, 65535) == 0);
+    CHECK(nes_set_render_interval(nes, 0) == 0);
+    nes_step_frame(nes);
+    CHECK(nes_framebuffer(nes) == NULL);
+    CHECK(nes_convert_frame(nes, pixels, NESEMU_SCREEN_WIDTH * 4, NESEMU_FORMAT_RGBA8888) == -1);
+
+    nes_destroy(nes);
+    nes_destroy(NULL);
+}
+
+
+int main(void)
+{
+    checkLifecycle();
+
+    printf("capi: %s\n", testFailures ? "FAILED" : "passed");
+    return testFailures ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "../inc/framepacer.h"
+#include "testing.h"
+
+#include <thread>
+
+/* Frame Pacer Test Definitions */
+#define PACER_TEST_HZ                       (double)(10.0)      /* 100 ms periods leave room for a loaded machine */
+#define PACER_TEST_PERIOD_MS                (U32)(100)
+#define PACER_TEST_GRID_FRAMES              (U32)(5)
+
+
+/**
+ * @brief Percentiles report the upper edge of the bin holding the sample, and
+ * the largest sample once they reach the overflow bin
+ *
+ */
+static void checkPercentile(void)
+{
+    LatencyHistogram histogram;
+    histogram.clear();
+    CHECK(histogram.percentile(0.5) == 0);
+    CHECK(histogram.meanUs() == 0);
+
+    // 90 samples in the first bin, 10 in the fourth
+    for(U32 i = 0; i < 90; i++)
+    {
+        histogram.record(50);
+    }
+    for(U32 i = 0; i < 10; i++)
+    {
+        histogram.record(3 * PACER_HISTOGRAM_BIN_US + 50);
+    }
+
+    CHECK(histogram.count == 100);
+    CHECK(histogram.meanUs() == (90 * 50 + 10 * 350) / 100);
+    CHECK(histogram.percentile(0.0) == PACER_HISTOGRAM_BIN_US);
+    CHECK(histogram.percentile(0.5) == PACER_HISTOGRAM_BIN_US);
+    CHECK(histogram.percentile(0.9) == PACER_HISTOGRAM_BIN_US);
+    CHECK(histogram.percentile(0.95) == 4 * PACER_HISTOGRAM_BIN_US);
+    CHECK(histogram.percentile(1.0) == 4 * PACER_HISTOGRAM_BIN_US);
+
+    // Bin edges: a sample on an edge belongs to the bin above it
+    histogram.clear();
+    histogram.record(PACER_HISTOGRAM_BIN_US - 1);
+    CHECK(histogram.percentile(1.0) == PACER_HISTOGRAM_BIN_US);
+    histogram.record(PACER_HISTOGRAM_BIN_US);
+    CHECK(histogram.percentile(1.0) == 2 * PACER_HISTOGRAM_BIN_US);
+
+    // Past the last bin the maximum is all that is known
+    U64 outlier = PACER_HISTOGRAM_BINS * PACER_HISTOGRAM_BIN_US + 1234;
+    histogram.record(outlier);
+    CHECK(histogram.overflow == 1);
+    CHECK(histogram.maxUs == outlier);
+    CHECK(histogram.percentile(1.0) == outlier);
+    CHECK(histogram.percentile(0.0) == PACER_HISTOGRAM_BIN_US);
+
+    histogram.clear();
+    CHECK(histogram.count == 0);
+    CHECK(histogram.overflow == 0);
+    CHECK(histogram.maxUs == 0);
+}
+
+
+/**
+ * @brief The refresh rate follows the video standard or an explicit rate
+ *
+ */
+static void checkRefreshRate(void)
+{
+    FramePacer pacer;
+    CHECK(pacer.getRefreshRate() == PACER_NTSC_HZ);
+
+    pacer.setStandard(VideoStandard::PAL);
+    CHECK(pacer.getRefreshRate() == PACER_PAL_HZ);
+
+    pacer.setRefreshRate(PACER_TEST_HZ);
+    CHECK(pacer.getRefreshRate() == PACER_TEST_HZ);
+}
+
+
+/**
+ * @brief Frames on time sleep to an absolute grid; a frame that overruns its
+ * deadline is late and the next one catches up; falling more than
+ * PACER_MAX_LAG_FRAMES behind restarts the grid instead
+ *
+ */
+static void checkDeadlines(void)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::milliseconds period(PACER_TEST_PERIOD_MS);
+
+    FramePacer pacer;
+    pacer.setRefreshRate(PACER_TEST_HZ);
+
+    // On time: whole periods from the first frame, no drift
+    Clock::time_point start = Clock::now();
+    for(U32 frame = 0; frame < PACER_TEST_GRID_FRAMES; frame++)
+    {
+        pacer.waitForNextFrame();
+    }
+    Clock::duration elapsed = Clock::now() - start;
+    CHECK(elapsed >= period * PACER_TEST_GRID_FRAMES);
+    CHECK(elapsed < period * (PACER_TEST_GRID_FRAMES + 1));
+
+    PacerMetrics metrics = pacer.getMetrics();
+    CHECK(metrics.frames == PACER_TEST_GRID_FRAMES);
+    CHECK(metrics.lateFrames == 0);
+    CHECK(metrics.resyncs == 0);
+    CHECK(metrics.overshoot.count == PACER_TEST_GRID_FRAMES);
+    CHECK(metrics.jitter.count == PACER_TEST_GRID_FRAMES - 1);
+
+    // Half a period over: late, and the next frame is due a period after the missed deadline
+    std::this_thread::sleep_for(period * 3 / 2);
+    pacer.waitForNextFrame();
+    Clock::time_point lateWake = Clock::now();
+    pacer.waitForNextFrame();
+    CHECK(Clock::now() - lateWake < period);
+
+    metrics = pacer.getMetrics();
+    CHECK(metrics.lateFrames == 1);
+    CHECK(metrics.resyncs == 0);
+
+    // Far behind: the grid restarts at the late frame instead of racing to catch up
+    // (without the restart the next deadline would already have passed)
+    std::this_thread::sleep_for(period * (PACER_MAX_LAG_FRAMES + 2));
+    pacer.waitForNextFrame();
+    Clock::time_point resyncWake = Clock::now();
+    pacer.waitForNextFrame();
+    CHECK(Clock::now() - resyncWake > period / 2);
+
+    metrics = pacer.getMetrics();
+    CHECK(metrics.lateFrames == 2);
+    CHECK(metrics.resyncs == 1);
+
+    // After restart() a pause isn't a late frame
+    pacer.resetMetrics();
+    std::this_thread::sleep_for(period * (PACER_MAX_LAG_FRAMES + 2));
+    pacer.restart();
+    pacer.waitForNextFrame();
+
+    metrics = pacer.getMetrics();
+    CHECK(metrics.frames == 1);
+    CHECK(metrics.lateFrames == 0);
+    CHECK(metrics.resyncs == 0);
+    CHECK(metrics.jitter.count == 0);
+}
+
+
+int main(void)
+{
+    checkPercentile();
+    checkRefreshRate();
+    checkDeadlines();
+
+    return testResult("framepacer");
+}
\ No newline at end of file
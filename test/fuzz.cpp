@@ -0,0 +1,68 @@
+#include "../inc/cpuvalidator.h"
+#include "testing.h"
+
+/* Fuzz Test Definitions */
+#define FUZZ_TEST_SEEDS                     (U64)(3)
+#define FUZZ_TEST_INSTRUCTIONS              (U64)(10000)    /* Short run per seed; nesEmu --fuzz runs longer */
+#define FUZZ_TEST_LANE                      (U32)(5)
+#define FUZZ_TEST_ADDR                      (U16)(0x0123)
+
+
+/**
+ * @brief Fixed seeds run clean: the reference interpreter and the lockstep
+ * engine agree on every instruction
+ *
+ */
+static void checkFixedSeeds(void)
+{
+    for(U64 seed = 1; seed <= FUZZ_TEST_SEEDS; seed++)
+    {
+        CPUDivergence divergence;
+        bool matched = InstructionFuzzer(seed).fuzz(LOCKSTEP_LANES, FUZZ_TEST_INSTRUCTIONS, &divergence);
+
+        CHECK(matched);
+        if(!matched)
+        {
+            std::fputs(divergence.report().c_str(), stderr);
+        }
+    }
+}
+
+
+/**
+ * @brief A lane that doesn't match its reference is reported with its lane
+ * and RAM address, and the validator stays stopped
+ *
+ */
+static void checkReportsDivergence(void)
+{
+    InstructionFuzzer fuzzer(9);
+    LockstepValidator validator(fuzzer.generateCartridge());
+
+    for(U32 lane = 0; lane < validator.getLaneCount(); lane++)
+    {
+        fuzzer.randomizeConsole(*validator.getReference(lane));
+    }
+    validator.syncLanes();
+    CHECK(validator.run(FUZZ_TEST_INSTRUCTIONS / 10, VALIDATOR_FUZZ_BLOCK));
+
+    RP2A03Lockstep* candidate = validator.getCandidate();
+    candidate->writeRAM(FUZZ_TEST_LANE, FUZZ_TEST_ADDR, candidate->readRAM(FUZZ_TEST_LANE, FUZZ_TEST_ADDR) ^ 0x01);
+
+    CHECK(!validator.run(1));
+    CHECK(validator.hasDiverged());
+    CHECK(validator.getDivergence().lane == FUZZ_TEST_LANE);
+    CHECK(validator.getDivergence().ramAddr == FUZZ_TEST_ADDR);
+    CHECK(validator.getDivergence().report().find("RAM $0123") != std::string::npos);
+
+    CHECK(!validator.run(1));
+}
+
+
+int main(void)
+{
+    checkFixedSeeds();
+    checkReportsDivergence();
+
+    return testResult("fuzz");
+}
\ No newline at end of file
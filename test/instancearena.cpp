@@ -0,0 +1,213 @@
+#include "../inc/nes.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#define ADDRESS_LIMIT_SUPPORTED
+#endif
+
+/* Arena Test Definitions */
+#define ARENA_TEST_BLOCK_SIZE               (size_t)(256 * 1024)
+#define ARENA_TEST_SLOTS_PER_CHUNK          (size_t)(ARENA_CHUNK_SIZE / ARENA_TEST_BLOCK_SIZE)
+#define ARENA_TEST_FRAMES                   (U32)(3)
+
+
+/* Instance type with a known slot size, in an arena of its own */
+struct TestBlock
+{
+    U8 data[ARENA_TEST_BLOCK_SIZE];
+};
+
+
+/**
+ * @brief Creating instances takes slots off the free list and destroying them
+ * puts the same slots back, without mapping more chunks
+ *
+ */
+static void checkRecycling(void)
+{
+    InstanceArena<TestBlock>& arena = InstanceArena<TestBlock>::instance();
+    CHECK(arena.getSlotCount() == 0);
+
+    // The first instance maps a chunk
+    InstanceArena<TestBlock>::Pointer first = arena.create();
+    CHECK(arena.getSlotCount() == ARENA_TEST_SLOTS_PER_CHUNK);
+    CHECK(arena.getFreeCount() == ARENA_TEST_SLOTS_PER_CHUNK - 1);
+    CHECK(reinterpret_cast<uintptr_t>(first.get()) % ARENA_SLOT_ALIGN == 0);
+
+    InstanceArena<TestBlock>::Pointer second = arena.create();
+    CHECK(arena.getFreeCount() == ARENA_TEST_SLOTS_PER_CHUNK - 2);
+    CHECK(second.get() != first.get());
+
+    // A freed slot is the next one handed out
+    TestBlock* freed = second.get();
+    second.reset();
+    CHECK(arena.getFreeCount() == ARENA_TEST_SLOTS_PER_CHUNK - 1);
+    second = arena.create();
+    CHECK(second.get() == freed);
+
+    // reserve() maps whole chunks until enough slots are free
+    CHECK(arena.reserve(ARENA_TEST_SLOTS_PER_CHUNK));
+    CHECK(arena.getSlotCount() == 2 * ARENA_TEST_SLOTS_PER_CHUNK);
+    CHECK(arena.getFreeCount() == 2 * ARENA_TEST_SLOTS_PER_CHUNK - 2);
+    CHECK(arena.reserve(1));
+    CHECK(arena.getSlotCount() == 2 * ARENA_TEST_SLOTS_PER_CHUNK);
+
+    first.reset();
+    second.reset();
+    CHECK(arena.getFreeCount() == arena.getSlotCount());
+}
+
+
+#ifdef ADDRESS_LIMIT_SUPPORTED
+/**
+ * @brief Once every slot is taken and no chunk can be mapped, create() throws
+ * std::bad_alloc and reserve() fails without changing the counts; a destroyed
+ * instance makes room again
+ *
+ * @details The address space limit is lowered to just above the current size,
+ * so mapping another chunk fails.
+ */
+static void checkExhaustion(void)
+{
+    InstanceArena<TestBlock>& arena = InstanceArena<TestBlock>::instance();
+    std::vector<InstanceArena<TestBlock>::Pointer> blocks;
+
+    while(arena.getFreeCount())
+    {
+        blocks.push_back(arena.create());
+    }
+    blocks.reserve(blocks.size() + 1);
+    size_t slots = arena.getSlotCount();
+
+    size_t pages = 0;
+    std::ifstream("/proc/self/statm") >> pages;
+
+    rlimit original;
+    getrlimit(RLIMIT_AS, &original);
+    rlimit limited = original;
+    limited.rlim_cur = pages * sysconf(_SC_PAGESIZE) + ARENA_CHUNK_SIZE / 2;
+    CHECK(setrlimit(RLIMIT_AS, &limited) == 0);
+
+    bool threw = false;
+    try
+    {
+        arena.create();
+    }
+    catch(const std::bad_alloc&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(!arena.reserve(1));
+    CHECK(arena.getSlotCount() == slots);
+    CHECK(arena.getFreeCount() == 0);
+
+    // Still no mapping needed to reuse a freed slot
+    blocks.pop_back();
+    blocks.push_back(arena.create());
+    CHECK(arena.getFreeCount() == 0);
+
+    setrlimit(RLIMIT_AS, &original);
+
+    blocks.clear();
+    CHECK(arena.getFreeCount() == slots);
+}
+#endif
+
+
+/**
+ * @brief A clone runs on exactly like its original, using one slot from each
+ * of the console, memory and PPU arenas
+ *
+ * @details The frame buffer of a rendering PPU is the one part of a clone that
+ * comes from the heap: it is copied, not shared. With rendering off there is
+ * no frame buffer to copy.
+ */
+static void checkClone(void)
+{
+    std::vector<U8> rom = makeTestROM(34);
+    const U16 intervals[2] = { 1, PPU_RENDER_NEVER };
+
+    for(U8 i = 0; i < 2; i++)
+    {
+        NES console;
+        console.loadROM(rom.data(), rom.size());
+        console.getPPU()->setRenderInterval(intervals[i]);
+        console.getBus()->writeToBus(0x2001, 0x1E);
+        for(U32 frame = 0; frame < ARENA_TEST_FRAMES; frame++)
+        {
+            console.stepFrame();
+        }
+
+        CHECK(NES::reserveInstances(1));
+        size_t freeConsoles = InstanceArena<NES>::instance().getFreeCount();
+        size_t freeMemories = InstanceArena<NESMemory>::instance().getFreeCount();
+        size_t freePPUs = InstanceArena<RP2C02>::instance().getFreeCount();
+
+        InstanceArena<NES>::Pointer clone = console.clone();
+        CHECK(InstanceArena<NES>::instance().getFreeCount() == freeConsoles - 1);
+        CHECK(InstanceArena<NESMemory>::instance().getFreeCount() == freeMemories - 1);
+        CHECK(InstanceArena<RP2C02>::instance().getFreeCount() == freePPUs - 1);
+
+        CHECK(clone->getRAM() != console.getRAM());
+        CHECK(std::equal(console.getRAM(), console.getRAM() + 0x0800, clone->getRAM()));
+
+        if(intervals[i] == PPU_RENDER_NEVER)
+        {
+            CHECK(console.getFrameBuffer() == nullptr);
+            CHECK(clone->getFrameBuffer() == nullptr);
+        }
+        else
+        {
+            CHECK(console.getFrameBuffer() != nullptr);
+            CHECK(clone->getFrameBuffer() != nullptr);
+            CHECK(clone->getFrameBuffer() != console.getFrameBuffer());
+            if(clone->getFrameBuffer() && console.getFrameBuffer())
+            {
+                CHECK(std::equal(console.getFrameBuffer(), console.getFrameBuffer() + PPU_FRAME_BUFFER_SIZE, clone->getFrameBuffer()));
+            }
+        }
+
+        StateTracker original(console);
+        StateTracker cloned(*clone);
+        CHECK(cloned.hash() == original.hash());
+
+        for(U32 frame = 0; frame < ARENA_TEST_FRAMES; frame++)
+        {
+            console.stepFrame();
+            clone->stepFrame();
+            CHECK(cloned.hash() == original.hash());
+        }
+        if(clone->getFrameBuffer() && console.getFrameBuffer())
+        {
+            CHECK(std::equal(console.getFrameBuffer(), console.getFrameBuffer() + PPU_FRAME_BUFFER_SIZE, clone->getFrameBuffer()));
+        }
+
+        // Destroying the clone hands all three slots back
+        NES* slot = clone.get();
+        clone.reset();
+        CHECK(InstanceArena<NES>::instance().getFreeCount() == freeConsoles);
+        CHECK(InstanceArena<NESMemory>::instance().getFreeCount() == freeMemories);
+        CHECK(InstanceArena<RP2C02>::instance().getFreeCount() == freePPUs);
+        CHECK(console.clone().get() == slot);
+    }
+}
+
+
+int main(void)
+{
+    checkRecycling();
+#ifdef ADDRESS_LIMIT_SUPPORTED
+    checkExhaustion();
+#endif
+    checkClone();
+
+    return testResult("instancearena");
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "../inc/nes.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+/* Interrupt Test Definitions */
+#define INTERRUPT_TEST_NMI_HANDLER          (U16)(0xC123)
+#define INTERRUPT_TEST_RESET_HANDLER        (U16)(0x8456)
+#define INTERRUPT_TEST_IRQ_HANDLER          (U16)(0xE789)
+#define INTERRUPT_TEST_SCANLINE             (U16)(100)
+#define INTERRUPT_TEST_MAX_INSTRUCTION      (U16)(3 * 8)    /* PPU dots an instruction can overrun by */
+
+
+/**
+ * @brief Test cartridge with known NMI, reset and IRQ vectors at the end of PRG ROM
+ *
+ */
+static std::vector<U8> makeVectorROM(U32 seed)
+{
+    std::vector<U8> rom = makeTestROM(seed);
+    size_t vectors = 16 + TEST_ROM_PRG_BANKS * 0x4000 - 6;
+
+    const U16 handlers[3] = { INTERRUPT_TEST_NMI_HANDLER, INTERRUPT_TEST_RESET_HANDLER, INTERRUPT_TEST_IRQ_HANDLER };
+    for(U8 i = 0; i < 3; i++)
+    {
+        rom[vectors + 2 * i] = static_cast<U8>(handlers[i]);
+        rom[vectors + 2 * i + 1] = static_cast<U8>(handlers[i] >> 8);
+    }
+
+    return rom;
+}
+
+
+/**
+ * @brief Reset, NMI and IRQ continue at the address stored in their vector
+ *
+ */
+static void checkVectors(void)
+{
+    std::vector<U8> rom = makeVectorROM(41);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+    RP2A03* cpu = console.getCPU();
+    CHECK(cpu->getPC() == INTERRUPT_TEST_RESET_HANDLER);
+
+    console.stepInstruction();
+    console.reset();
+    CHECK(cpu->getPC() == INTERRUPT_TEST_RESET_HANDLER);
+
+    // NMI pushes the return address and status, then masks IRQs
+    U16 pc = cpu->getPC();
+    U8 sp = cpu->getSP();
+    U8 status = cpu->getStatus();
+    cpu->NMI();
+
+    CHECK(cpu->getPC() == INTERRUPT_TEST_NMI_HANDLER);
+    CHECK(cpu->getSP() == static_cast<U8>(sp - 3));
+    CHECK(console.getRAM()[0x0100 | sp] == static_cast<U8>(pc >> 8));
+    CHECK(console.getRAM()[0x0100 | static_cast<U8>(sp - 1)] == static_cast<U8>(pc));
+    CHECK(console.getRAM()[0x0100 | static_cast<U8>(sp - 2)] == ((status & ~Flags::BREAK_FLAG) | Flags::UNUSED_FLAG));
+    CHECK(cpu->getStatus() & Flags::INTERRUPT_DISABLE_FLAG);
+
+    // IRQ is masked, then taken once the flag is cleared
+    cpu->IRQ();
+    CHECK(cpu->getPC() == INTERRUPT_TEST_NMI_HANDLER);
+
+    cpu->setRegisters(cpu->getPC(), cpu->getSP(), cpu->getA(), cpu->getX(), cpu->getY(), Flags::UNUSED_FLAG);
+    cpu->IRQ();
+    CHECK(cpu->getPC() == INTERRUPT_TEST_IRQ_HANDLER);
+}
+
+
+/**
+ * @brief Powers a console on with IRQs unmasked and a scanline IRQ pending
+ *
+ */
+static void armScanlineIRQ(NES& console, const std::vector<U8>& rom)
+{
+    console.loadROM(rom.data(), rom.size());
+
+    RP2A03* cpu = console.getCPU();
+    cpu->setRegisters(cpu->getPC(), cpu->getSP(), cpu->getA(), cpu->getX(), cpu->getY(), Flags::UNUSED_FLAG);
+    console.getBus()->setScanlineIRQ(INTERRUPT_TEST_SCANLINE);
+}
+
+
+/**
+ * @brief A cartridge scanline IRQ raises the IRQ line at dot 260 of its
+ * scanline, the CPU takes it right away, and it stays asserted until the
+ * cartridge acknowledges it
+ *
+ * @details The same frame run event by event (stepFrame) ends in the same state.
+ */
+static void checkScanlineIRQ(void)
+{
+    std::vector<U8> rom = makeVectorROM(42);
+
+    NES stepped;
+    armScanlineIRQ(stepped, rom);
+
+    Bus* bus = stepped.getBus();
+    RP2C02* ppu = stepped.getPPU();
+    bool taken = false;
+
+    while(!taken && ppu->getFrameCount() == 0)
+    {
+        bool asserted = bus->isIRQAsserted();
+        stepped.stepInstruction();
+        taken = (stepped.getCPU()->getPC() == INTERRUPT_TEST_IRQ_HANDLER);
+
+        // Not before the IRQ line is raised, and on the very next instruction after it is
+        CHECK(taken == asserted);
+    }
+
+    CHECK(taken);
+    CHECK(ppu->getScanline() == INTERRUPT_TEST_SCANLINE);
+    CHECK(ppu->getDot() >= BUS_SCANLINE_IRQ_DOT);
+    CHECK(ppu->getDot() <= BUS_SCANLINE_IRQ_DOT + 2 * INTERRUPT_TEST_MAX_INSTRUCTION);
+
+    // Level triggered: held until acknowledged, and fires only once
+    CHECK(bus->isIRQAsserted());
+    bus->acknowledgeScanlineIRQ();
+    CHECK(!bus->isIRQAsserted());
+
+    while(ppu->getFrameCount() == 0)
+    {
+        stepped.stepInstruction();
+        CHECK(!bus->isIRQAsserted());
+    }
+
+    // Event driven: the CPU runs up to the IRQ in one go
+    NES eventDriven;
+    armScanlineIRQ(eventDriven, rom);
+    eventDriven.stepFrame();
+    eventDriven.getBus()->acknowledgeScanlineIRQ();
+
+    StateTracker steppedState(stepped);
+    StateTracker eventState(eventDriven);
+    CHECK(eventDriven.getCPU()->getCycles() == stepped.getCPU()->getCycles());
+    CHECK(eventState.hash() == steppedState.hash());
+}
+
+
+int main(void)
+{
+    checkVectors();
+    checkScanlineIRQ();
+
+    return testResult("interrupts");
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "../inc/cpuvalidator.h"
+#include "testing.h"
+
+#include <cstring>
+
+/* Lockstep Test Definitions */
+#define LOCKSTEP_TEST_INSTRUCTIONS          (U64)(4000)
+#define LOCKSTEP_TEST_PARTIAL_LANES         (U32)(7)
+
+
+/**
+ * @brief Lane states for a run: one random state per lane, or the same random
+ * state on every lane (which keeps all lanes on one opcode, the full-width
+ * vector case)
+ *
+ */
+static void seedLanes(LockstepValidator& validator, InstructionFuzzer& fuzzer, bool shared)
+{
+    NES* first = validator.getReference(0);
+    fuzzer.randomizeConsole(*first);
+
+    for(U32 lane = 1; lane < validator.getLaneCount(); lane++)
+    {
+        NES* console = validator.getReference(lane);
+
+        if(!shared)
+        {
+            fuzzer.randomizeConsole(*console);
+            continue;
+        }
+
+        RP2A03* cpu = first->getCPU();
+        console->getCPU()->setRegisters(cpu->getPC(), cpu->getSP(), cpu->getA(), cpu->getX(), cpu->getY(), cpu->getStatus());
+        std::memcpy(console->getRAM(), first->getRAM(), LOCKSTEP_RAM_SIZE);
+    }
+
+    validator.syncLanes();
+}
+
+
+/**
+ * @brief N lockstep lanes match N scalar RP2A03 instances, registers and
+ * internal RAM, after every instruction
+ *
+ */
+static void checkAgainstScalar(LockstepISA isa, U32 lanes, bool shared, U64 seed)
+{
+    InstructionFuzzer fuzzer(seed);
+    LockstepValidator validator(fuzzer.generateCartridge(), lanes);
+    validator.getCandidate()->setISA(isa);
+
+    seedLanes(validator, fuzzer, shared);
+
+    bool matched = validator.run(LOCKSTEP_TEST_INSTRUCTIONS);
+    CHECK(matched);
+    if(!matched)
+    {
+        std::fputs(validator.getDivergence().report().c_str(), stderr);
+    }
+
+    CHECK(validator.getInstructionCount() == LOCKSTEP_TEST_INSTRUCTIONS);
+}
+
+
+/**
+ * @brief Kernel selection only ever steps down from what the CPU supports
+ *
+ */
+static void checkISASelection(void)
+{
+    RP2A03Lockstep lockstep;
+    LockstepISA best = lockstep.getISA();
+
+    lockstep.setISA(LockstepISA::portable);
+    CHECK(lockstep.getISA() == LockstepISA::portable);
+
+    lockstep.setISA(LockstepISA::avx512);
+    CHECK(lockstep.getISA() == best);
+}
+
+
+int main(void)
+{
+    checkISASelection();
+
+    const LockstepISA sets[3] = { LockstepISA::avx512, LockstepISA::avx2, LockstepISA::portable };
+    for(U32 i = 0; i < 3; i++)
+    {
+        checkAgainstScalar(sets[i], LOCKSTEP_LANES, false, 100 + i);
+        checkAgainstScalar(sets[i], LOCKSTEP_LANES, true, 200 + i);
+        checkAgainstScalar(sets[i], LOCKSTEP_TEST_PARTIAL_LANES, false, 300 + i);
+    }
+
+    return testResult("lockstep");
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "../inc/netplay.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define UDP_SUPPORTED
+#endif
+
+/* Netplay Test Definitions */
+#define NETPLAY_TEST_INPUT_FRAMES           (U32)(90)   /* Frames with changing inputs, then both players let go */
+#define NETPLAY_TEST_ROLLBACK               (U32)(8)
+#define NETPLAY_TEST_FRAMES                 (U32)(NETPLAY_TEST_INPUT_FRAMES + 3 * NETPLAY_TEST_ROLLBACK)
+#define NETPLAY_TEST_CATCH_UP               (U32)(2)    /* Frames re-simulated per call in the catch-up run */
+#define NETPLAY_TEST_UDP_PORT               (U16)(41000)
+
+
+/**
+ * @brief Buttons of a player; every frame differs, so most predictions miss
+ *
+ */
+static U8 playerInput(U8 port, U32 frame)
+{
+    if(frame >= NETPLAY_TEST_INPUT_FRAMES)
+    {
+        return 0;
+    }
+
+    return static_cast<U8>(port ? (frame * 91 + 5) : (frame * 37));
+}
+
+
+/**
+ * @brief Powers a console on with the test cartridge and the controller strobe
+ * held high, so every $4016 read the program does latches the current buttons
+ *
+ */
+static void powerOn(NES& console, const std::vector<U8>& rom)
+{
+    console.loadROM(rom.data(), rom.size());
+    console.getBus()->writeToBus(0x4016, 1);
+}
+
+
+/**
+ * @brief Two sessions over a link end in the state of a console that was given
+ * both players' inputs directly
+ *
+ * @details Both players' inputs stop changing NETPLAY_TEST_INPUT_FRAMES in and
+ * each console runs three rollback windows further, by which point every
+ * misprediction has been received and rolled back. One console renders
+ * through the pipeline, so re-simulation with suppressed output is covered
+ * with and without the render worker.
+ *
+ * @param catchUpLimit Frames re-simulated per advanceFrame() (0: not limited)
+ */
+static void checkConvergence(Transport& local, Transport& remote, U32 seed, U32 catchUpLimit)
+{
+    std::vector<U8> rom = makeTestROM(seed);
+
+    NES reference;
+    powerOn(reference, rom);
+    for(U32 frame = 0; frame < NETPLAY_TEST_FRAMES; frame++)
+    {
+        reference.setInput(0, playerInput(0, frame));
+        reference.setInput(1, playerInput(1, frame));
+        reference.stepFrame();
+    }
+
+    NES consoles[2];
+    powerOn(consoles[0], rom);
+    powerOn(consoles[1], rom);
+    consoles[1].getBus()->setPipelinedRendering(true);
+
+    RollbackSession sessions[2] =
+    {
+        RollbackSession(consoles[0], local, 0, NETPLAY_TEST_ROLLBACK),
+        RollbackSession(consoles[1], remote, 1, NETPLAY_TEST_ROLLBACK)
+    };
+
+    if(catchUpLimit)
+    {
+        sessions[0].setCatchUpLimit(catchUpLimit);
+        sessions[1].setCatchUpLimit(catchUpLimit);
+    }
+
+    while(sessions[0].getFrame() < NETPLAY_TEST_FRAMES || sessions[1].getFrame() < NETPLAY_TEST_FRAMES)
+    {
+        for(U8 port = 0; port < 2; port++)
+        {
+            if(sessions[port].getFrame() < NETPLAY_TEST_FRAMES)
+            {
+                sessions[port].advanceFrame(playerInput(port, sessions[port].getFrame()));
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    StateTracker referenceState(reference);
+    StateTracker localState(consoles[0]);
+    StateTracker remoteState(consoles[1]);
+
+    CHECK(sessions[0].getStats().rollbacks + sessions[1].getStats().rollbacks > 0);
+    CHECK(localState.hash() == remoteState.hash());
+    CHECK(localState.hash() == referenceState.hash());
+
+    // Deeper rollbacks than the limit were spread over several calls
+    if(catchUpLimit)
+    {
+        CHECK(sessions[0].getStats().catchUps + sessions[1].getStats().catchUps > 0);
+    }
+
+    // Suppression is lifted again and the frame buffers survive re-simulation
+    CHECK(!consoles[0].getPPU()->isOutputSuppressed());
+    CHECK(!consoles[1].getPPU()->isOutputSuppressed());
+    CHECK(consoles[0].getFrameBuffer() != nullptr);
+}
+
+
+/**
+ * @brief Convergence over an in-process link with latency, jitter and loss
+ *
+ */
+static void checkLoopbackConvergence(U32 latencyMs, U32 jitterMs, double loss, U32 seed, U32 catchUpLimit = 0)
+{
+    FakeLink link(latencyMs, jitterMs, loss, seed);
+    checkConvergence(link.getEndpoint(0), link.getEndpoint(1), seed, catchUpLimit);
+}
+
+
+#ifdef UDP_SUPPORTED
+/**
+ * @brief Packets make it across a pair of loopback UDP sockets, and sessions
+ * over them converge
+ *
+ * @details Ports depend on the process id, so parallel runs don't collide.
+ */
+static void checkUDPConvergence(U32 seed)
+{
+    U16 port = static_cast<U16>(NETPLAY_TEST_UDP_PORT + 2 * (getpid() % 1000));
+
+    UDPTransport local(port, "127.0.0.1", port + 1);
+    UDPTransport remote(port + 1, "127.0.0.1", port);
+    CHECK(local.isOpen());
+    CHECK(remote.isOpen());
+    if(!local.isOpen() || !remote.isOpen())
+    {
+        return;
+    }
+
+    // Nothing pending yet, and receive() doesn't block
+    U8 buffer[TRANSPORT_MAX_PACKET];
+    CHECK(remote.receive(buffer, sizeof(buffer)) == 0);
+
+    const U8 packet[4] = { 0x4E, 0x45, 0x53, 0x1A };
+    CHECK(local.send(packet, sizeof(packet)));
+
+    size_t size = 0;
+    for(U32 i = 0; i < 100 && size == 0; i++)
+    {
+        size = remote.receive(buffer, sizeof(buffer));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(size == sizeof(packet));
+    CHECK(std::equal(packet, packet + sizeof(packet), buffer));
+
+    checkConvergence(local, remote, seed, 0);
+}
+#endif
+
+
+/**
+ * @brief Measuring the rollback capacity leaves the console as it was and sets
+ * the catch-up limit from the result
+ *
+ */
+static void checkRollbackCapacity(void)
+{
+    std::vector<U8> rom = makeTestROM(5);
+
+    NES console;
+    powerOn(console, rom);
+    for(U32 frame = 0; frame < 3; frame++)
+    {
+        console.stepFrame();
+    }
+
+    FakeLink link(0, 0);
+    RollbackSession session(console, link.getEndpoint(0), 0, NETPLAY_TEST_ROLLBACK);
+    session.advanceFrame(0);
+
+    StateTracker state(console);
+    U64 before = state.hash();
+    U64 frameCount = console.getPPU()->getFrameCount();
+
+    U32 capacity = session.measureRollbackCapacity();
+
+    CHECK(capacity > 0);
+    CHECK(state.hash() == before);
+    CHECK(console.getPPU()->getFrameCount() == frameCount);
+    CHECK(!console.getPPU()->isOutputSuppressed());
+    CHECK(session.getCatchUpLimit() == ((capacity > 1) ? capacity - 1 : 1));
+
+    // The session carries on from where it was
+    CHECK(session.advanceFrame(0));
+    CHECK(session.getFrame() == 2);
+}
+
+
+int main(void)
+{
+    checkLoopbackConvergence(0, 0, 0.0, 1);
+    checkLoopbackConvergence(4, 3, 0.0, 2);
+    checkLoopbackConvergence(6, 4, 0.25, 3);
+    checkLoopbackConvergence(6, 4, 0.25, 4, NETPLAY_TEST_CATCH_UP);
+#ifdef UDP_SUPPORTED
+    checkUDPConvergence(6);
+#endif
+    checkRollbackCapacity();
+
+    return testResult("netplay");
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "../inc/nes.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <algorithm>
+
+/* OAM DMA Test Definitions */
+#define DMA_TEST_INSTRUCTIONS               (U32)(64)
+#define DMA_TEST_PAGE                       (U8)(0x02)
+#define DMA_TEST_STALL                      (U64)(513)      /* Halt cycle + 256 read/write pairs */
+
+
+/**
+ * @brief Registers of a CPU, to compare two of them
+ *
+ */
+static std::vector<U64> registers(RP2A03* cpu)
+{
+    return {cpu->getPC(), cpu->getSP(), cpu->getA(), cpu->getX(), cpu->getY(), cpu->getStatus()};
+}
+
+
+/**
+ * @brief A $4014 write halts the CPU for 513 cycles, 514 when the DMA starts
+ * on an odd cycle, while the PPU keeps running; then the CPU carries on
+ * exactly where it would have without the DMA
+ *
+ * @details Each instruction is run twice from the same state, once after a
+ * $4014 write, so both start parities come up.
+ */
+static void checkStall(void)
+{
+    std::vector<U8> rom = makeTestROM(36);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+    for(U16 i = 0; i < 256; i++)
+    {
+        console.getRAM()[(DMA_TEST_PAGE << 8) | i] = static_cast<U8>(i ^ 0x5A);
+    }
+
+    bool seen[2] = { false, false };
+
+    for(U32 i = 0; i < DMA_TEST_INSTRUCTIONS; i++)
+    {
+        InstanceArena<NES>::Pointer plain = console.clone();
+        InstanceArena<NES>::Pointer dma = console.clone();
+
+        dma->getBus()->writeToBus(MemoryMap::MEM_IO_OAM_DMA_ADDR, DMA_TEST_PAGE);
+        plain->stepInstruction();
+        dma->stepInstruction();
+
+        // The DMA starts after the instruction that wrote $4014
+        U64 start = plain->getCPU()->getCycles();
+        U64 stall = dma->getCPU()->getCycles() - start;
+        CHECK(stall == DMA_TEST_STALL + (start & 0x01));
+        seen[start & 0x01] = true;
+
+        // The PPU ran on through the halt
+        CHECK(dma->getPPU()->getDotCount() - plain->getPPU()->getDotCount() == 3 * stall);
+
+        // OAM holds the page; the CPU resumes with the same registers and program
+        CHECK(std::equal(dma->getPPU()->getOAM(), dma->getPPU()->getOAM() + 256, &dma->getRAM()[DMA_TEST_PAGE << 8]));
+        CHECK(registers(dma->getCPU()) == registers(plain->getCPU()));
+
+        plain->stepInstruction();
+        dma->stepInstruction();
+        CHECK(registers(dma->getCPU()) == registers(plain->getCPU()));
+        CHECK(dma->getCPU()->getCycles() - plain->getCPU()->getCycles() == stall);
+
+        console.stepInstruction();
+    }
+
+    CHECK(seen[0]);
+    CHECK(seen[1]);
+}
+
+
+/**
+ * @brief Two DMAs from one instruction are halted back to back, the second
+ * aligned after the first
+ *
+ */
+static void checkBackToBack(void)
+{
+    std::vector<U8> rom = makeTestROM(37);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+
+    InstanceArena<NES>::Pointer plain = console.clone();
+    console.getBus()->writeToBus(MemoryMap::MEM_IO_OAM_DMA_ADDR, DMA_TEST_PAGE);
+    console.getBus()->writeToBus(MemoryMap::MEM_IO_OAM_DMA_ADDR, DMA_TEST_PAGE);
+    plain->stepInstruction();
+    console.stepInstruction();
+
+    U64 start = plain->getCPU()->getCycles();
+    U64 first = DMA_TEST_STALL + (start & 0x01);
+    U64 second = DMA_TEST_STALL + ((start + first) & 0x01);
+    CHECK(console.getCPU()->getCycles() - start == first + second);
+}
+
+
+/**
+ * @brief A DMA across vblank ends the frame in the same state whether the
+ * CPU runs event by event (stepFrame) or instruction by instruction
+ *
+ */
+static void checkEventDriven(void)
+{
+    std::vector<U8> rom = makeTestROM(38);
+
+    NES eventDriven;
+    NES stepped;
+    eventDriven.loadROM(rom.data(), rom.size());
+    stepped.loadROM(rom.data(), rom.size());
+
+    for(U32 frame = 0; frame < 4; frame++)
+    {
+        eventDriven.getBus()->writeToBus(MemoryMap::MEM_IO_OAM_DMA_ADDR, DMA_TEST_PAGE);
+        stepped.getBus()->writeToBus(MemoryMap::MEM_IO_OAM_DMA_ADDR, DMA_TEST_PAGE);
+
+        eventDriven.stepFrame();
+
+        U64 target = stepped.getPPU()->getFrameCount() + 1;
+        while(stepped.getPPU()->getFrameCount() < target)
+        {
+            stepped.stepInstruction();
+        }
+
+        StateTracker eventState(eventDriven);
+        StateTracker steppedState(stepped);
+        CHECK(eventDriven.getCPU()->getCycles() == stepped.getCPU()->getCycles());
+        CHECK(eventState.hash() == steppedState.hash());
+    }
+}
+
+
+int main(void)
+{
+    checkStall();
+    checkBackToBack();
+    checkEventDriven();
+
+    return testResult("oamdma");
+}
\ No newline at end of file
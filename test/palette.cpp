@@ -0,0 +1,139 @@
+#include "../inc/palette.h"
+#include "testing.h"
+
+#include <cstring>
+
+/* Palette Test Definitions */
+#define PALETTE_TEST_PADDING                (size_t)(16)    /* Guard bytes after each destination row */
+#define PALETTE_TEST_GUARD                  (U8)(0xA5)
+
+
+/**
+ * @brief Frame buffer that uses every color under every emphasis combination,
+ * with junk in the two bits above the 6-bit color
+ *
+ * @details Row r is emphasized with (r % 8) and its 256 pixels cycle through
+ * all 64 colors, starting at a different color on every row.
+ */
+static std::vector<U8> makeFrame(void)
+{
+    std::vector<U8> frame(PPU_FRAME_BUFFER_SIZE, 0);
+    std::mt19937 random(32);
+
+    for(U16 row = 0; row < PPU_SCREEN_HEIGHT; row++)
+    {
+        for(U16 x = 0; x < PPU_SCREEN_WIDTH; x++)
+        {
+            U8 color = static_cast<U8>((x + row) & (PALETTE_COLORS - 1));
+            frame[row * PPU_SCREEN_WIDTH + x] = static_cast<U8>(color | (random() & 0xC0));
+        }
+        frame[PPU_EMPHASIS_OFFSET + row] = static_cast<U8>(row % PALETTE_EMPHASIS_COMBINATIONS);
+    }
+
+    return frame;
+}
+
+
+/**
+ * @brief Converts a frame into a padded destination, checking the padding is left alone
+ *
+ */
+static std::vector<U8> convert(const PaletteConverter& converter, const std::vector<U8>& frame, PixelFormat format)
+{
+    size_t rowBytes = PPU_SCREEN_WIDTH * ((format == PixelFormat::RGB565) ? 2 : 4);
+    size_t pitch = rowBytes + PALETTE_TEST_PADDING;
+    std::vector<U8> pixels(pitch * PPU_SCREEN_HEIGHT, PALETTE_TEST_GUARD);
+
+    converter.convertFrame(frame.data(), pixels.data(), pitch, format);
+
+    bool guarded = true;
+    for(U16 row = 0; row < PPU_SCREEN_HEIGHT; row++)
+    {
+        for(size_t i = rowBytes; i < pitch; i++)
+        {
+            guarded &= (pixels[row * pitch + i] == PALETTE_TEST_GUARD);
+        }
+    }
+    CHECK(guarded);
+
+    return pixels;
+}
+
+
+/**
+ * @brief The AVX2 and scalar paths write identical pixels in every format for
+ * all 64 x 8 palette entries
+ *
+ * @details On CPUs without AVX2 both converters take the scalar path.
+ */
+static void checkPathsMatch(void)
+{
+    PaletteConverter simd;
+    PaletteConverter scalar;
+    scalar.setSIMD(false);
+    CHECK(!scalar.usesSIMD());
+    CHECK(simd.usesSIMD() == PaletteConverter::instance().usesSIMD());
+
+    std::vector<U8> frame = makeFrame();
+    const PixelFormat formats[3] = { PixelFormat::RGBA8888, PixelFormat::BGRA8888, PixelFormat::RGB565 };
+
+    for(PixelFormat format : formats)
+    {
+        CHECK(convert(simd, frame, format) == convert(scalar, frame, format));
+    }
+
+    // Turning SIMD back on only works where the CPU has it
+    scalar.setSIMD(true);
+    CHECK(scalar.usesSIMD() == simd.usesSIMD());
+}
+
+
+/**
+ * @brief Known entries come out in each format's byte order
+ *
+ * @details Color $30 is 0xFFFEFF. Red emphasis scales green and blue by
+ * PALETTE_EMPHASIS_ATTENUATION.
+ */
+static void checkByteOrder(void)
+{
+    std::vector<U8> frame(PPU_FRAME_BUFFER_SIZE, 0x30);
+    frame[PPU_EMPHASIS_OFFSET + 1] = 0x01;
+
+    U8 green = static_cast<U8>(0xFE * PALETTE_EMPHASIS_ATTENUATION + 0.5);
+    U8 blue = static_cast<U8>(0xFF * PALETTE_EMPHASIS_ATTENUATION + 0.5);
+    size_t pitch32 = PPU_SCREEN_WIDTH * 4 + PALETTE_TEST_PADDING;
+    size_t pitch16 = PPU_SCREEN_WIDTH * 2 + PALETTE_TEST_PADDING;
+
+    PaletteConverter converters[2];
+    converters[1].setSIMD(false);
+
+    for(const PaletteConverter& converter : converters)
+    {
+        std::vector<U8> rgba = convert(converter, frame, PixelFormat::RGBA8888);
+        std::vector<U8> bgra = convert(converter, frame, PixelFormat::BGRA8888);
+        std::vector<U8> rgb565 = convert(converter, frame, PixelFormat::RGB565);
+
+        const U8 plainRGBA[4] = { 0xFF, 0xFE, 0xFF, 0xFF };
+        const U8 emphasizedRGBA[4] = { 0xFF, green, blue, 0xFF };
+        const U8 emphasizedBGRA[4] = { blue, green, 0xFF, 0xFF };
+        CHECK(std::memcmp(&rgba[0], plainRGBA, 4) == 0);
+        CHECK(std::memcmp(&rgba[pitch32], emphasizedRGBA, 4) == 0);
+        CHECK(std::memcmp(&bgra[pitch32], emphasizedBGRA, 4) == 0);
+
+        U16 plain565;
+        U16 emphasized565;
+        std::memcpy(&plain565, &rgb565[0], sizeof(U16));
+        std::memcpy(&emphasized565, &rgb565[pitch16], sizeof(U16));
+        CHECK(plain565 == 0xFFFF);
+        CHECK(emphasized565 == ((0x1F << 11) | ((green >> 2) << 5) | (blue >> 3)));
+    }
+}
+
+
+int main(void)
+{
+    checkPathsMatch();
+    checkByteOrder();
+
+    return testResult("palette");
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "../inc/nes.h"
+#include "testing.h"
+
+#include <algorithm>
+
+/* Pipeline Test Definitions */
+#define PIPELINE_TEST_FRAMES                (U32)(40)
+#define PIPELINE_TEST_SAVE_FRAME            (U32)(10)
+#define PIPELINE_TEST_ROLLBACK_PERIOD       (U32)(7)    /* Roll back every 7th frame */
+
+
+/**
+ * @brief Powers a console on with a palette, a filled name table and rendering enabled
+ *
+ */
+static void powerOn(NES& console, const std::vector<U8>& rom)
+{
+    console.loadROM(rom.data(), rom.size());
+
+    Bus* bus = console.getBus();
+    bus->writeToBus(0x2006, 0x3F);
+    bus->writeToBus(0x2006, 0x00);
+    for(U8 i = 0; i < 32; i++)
+    {
+        bus->writeToBus(0x2007, static_cast<U8>(i * 3));
+    }
+
+    bus->writeToBus(0x2006, 0x20);
+    bus->writeToBus(0x2006, 0x00);
+    for(U16 i = 0; i < 960; i++)
+    {
+        bus->writeToBus(0x2007, static_cast<U8>(i * 7));
+    }
+
+    bus->writeToBus(0x2001, 0x1E);
+}
+
+
+/**
+ * @brief Pipelined rendering produces the synchronous frames one frame later,
+ * across mid-run scroll changes and state rollbacks
+ *
+ */
+static void checkMatchesSynchronous(void)
+{
+    std::vector<U8> rom = makeTestROM(27);
+
+    NES pipelined;
+    NES synchronous;
+    powerOn(pipelined, rom);
+    powerOn(synchronous, rom);
+    pipelined.getBus()->setPipelinedRendering(true);
+
+    std::vector<U8> state(pipelined.stateSize());
+    std::vector<U8> previous;
+    bool drawn = false;
+
+    for(U32 frame = 0; frame < PIPELINE_TEST_FRAMES; frame++)
+    {
+        if(frame == PIPELINE_TEST_SAVE_FRAME)
+        {
+            CHECK(pipelined.saveState(state.data(), state.size()) == state.size());
+        }
+        if(frame > PIPELINE_TEST_SAVE_FRAME && (frame % PIPELINE_TEST_ROLLBACK_PERIOD) == 0)
+        {
+            CHECK(pipelined.loadState(state.data(), state.size()));
+            CHECK(synchronous.loadState(state.data(), state.size()));
+        }
+
+        NES* consoles[2] = { &pipelined, &synchronous };
+        for(NES* console : consoles)
+        {
+            console->getBus()->writeToBus(0x2005, static_cast<U8>(frame));
+            console->getBus()->writeToBus(0x2005, static_cast<U8>(frame * 2));
+            console->stepFrame();
+        }
+
+        if(!previous.empty())
+        {
+            CHECK(std::equal(previous.begin(), previous.end(), pipelined.getFrameBuffer()));
+        }
+
+        const U8* frameBuffer = synchronous.getFrameBuffer();
+        previous.assign(frameBuffer, frameBuffer + PPU_FRAME_BUFFER_SIZE);
+        drawn |= std::any_of(previous.begin(), previous.end(), [](U8 pixel){ return pixel != 0; });
+    }
+
+    CHECK(drawn);
+}
+
+
+/**
+ * @brief The PPU gets its frame buffer back, holding the last presented frame,
+ * when the pipeline is turned off or the console is cloned; with rendering
+ * turned off while pipelined it stays without one
+ *
+ */
+static void checkDetach(void)
+{
+    std::vector<U8> rom = makeTestROM(28);
+
+    NES console;
+    powerOn(console, rom);
+    console.getBus()->setPipelinedRendering(true);
+    for(U32 frame = 0; frame < 3; frame++)
+    {
+        console.stepFrame();
+    }
+
+    // A clone renders synchronously from the presented frame
+    std::vector<U8> presented(console.getFrameBuffer(), console.getFrameBuffer() + PPU_FRAME_BUFFER_SIZE);
+    U64 presentedFrame = console.getPPU()->getFrameBufferFrame();
+    InstanceArena<NES>::Pointer clone = console.clone();
+    CHECK(clone->getFrameBuffer() != nullptr);
+    CHECK(clone->getFrameBuffer() != console.getFrameBuffer());
+    CHECK(std::equal(presented.begin(), presented.end(), clone->getFrameBuffer()));
+    CHECK(clone->getPPU()->getFrameBufferFrame() == presentedFrame);
+
+    // Turning the pipeline off hands over the frame it had in flight
+    console.stepFrame();
+    clone->stepFrame();
+    console.getBus()->setPipelinedRendering(false);
+    CHECK(console.getFrameBuffer() != nullptr);
+    CHECK(std::equal(clone->getFrameBuffer(), clone->getFrameBuffer() + PPU_FRAME_BUFFER_SIZE, console.getFrameBuffer()));
+    CHECK(console.getPPU()->getFrameBufferFrame() == clone->getPPU()->getFrameBufferFrame());
+
+    // Rendering turned off while pipelined stays off afterwards
+    console.getBus()->setPipelinedRendering(true);
+    console.getPPU()->setRenderInterval(PPU_RENDER_NEVER);
+    console.stepFrame();
+    console.getBus()->setPipelinedRendering(false);
+    CHECK(console.getFrameBuffer() == nullptr);
+}
+
+
+int main(void)
+{
+    checkMatchesSynchronous();
+    checkDetach();
+
+    return testResult("ppupipeline");
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "../inc/nes.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <random>
+
+/* Render Interval Test Definitions */
+#define INTERVAL_TEST_FRAMES                (U32)(12)
+#define INTERVAL_TEST_OVERFLOW_Y            (U8)(60)        /* Nine sprites share this row */
+#define INTERVAL_TEST_SKIP                  (U16)(3)
+
+
+/**
+ * @brief Powers a console on with random name tables and OAM, nine sprites on
+ * one row, and background, sprites and NMI enabled
+ *
+ */
+static void powerOn(NES& console, const std::vector<U8>& rom, U16 interval)
+{
+    console.loadROM(rom.data(), rom.size());
+    console.getPPU()->setRenderInterval(interval);
+
+    Bus* bus = console.getBus();
+    std::mt19937 random(26);
+
+    bus->writeToBus(0x2006, 0x20);
+    bus->writeToBus(0x2006, 0x00);
+    for(U16 i = 0; i < 0x0800; i++)
+    {
+        bus->writeToBus(0x2007, static_cast<U8>(random()));
+    }
+
+    bus->writeToBus(0x2003, 0x00);
+    for(U16 i = 0; i < 256; i++)
+    {
+        bool overflowRow = ((i & 0x03) == 0) && (i < 9 * 4);
+        U8 data = static_cast<U8>(random());
+        bus->writeToBus(0x2004, overflowRow ? INTERVAL_TEST_OVERFLOW_Y : data);
+    }
+
+    bus->writeToBus(0x2005, 0x00);
+    bus->writeToBus(0x2005, 0x00);
+    bus->writeToBus(0x2000, 0x80);
+    bus->writeToBus(0x2001, 0x1E);
+}
+
+
+/**
+ * @brief Frame skip only changes pixel output: a console that renders every
+ * frame, one that skips frames and one that never renders read the same
+ * $2002 values instruction by instruction and end every frame with the same
+ * state hash
+ *
+ */
+static void checkSkipMatchesRendering(void)
+{
+    std::vector<U8> rom = makeTestROM(26);
+    const U16 intervals[3] = { 1, INTERVAL_TEST_SKIP, PPU_RENDER_NEVER };
+
+    NES consoles[3];
+    for(U8 i = 0; i < 3; i++)
+    {
+        powerOn(consoles[i], rom, intervals[i]);
+    }
+
+    StateTracker rendered(consoles[0]);
+    StateTracker skipped(consoles[1]);
+    StateTracker never(consoles[2]);
+    U8 seen = 0;
+
+    for(U32 frame = 0; frame < INTERVAL_TEST_FRAMES; frame++)
+    {
+        U64 target = consoles[0].getPPU()->getFrameCount() + 1;
+        while(consoles[0].getPPU()->getFrameCount() < target)
+        {
+            U8 status[3];
+            for(U8 i = 0; i < 3; i++)
+            {
+                consoles[i].stepInstruction();
+                status[i] = consoles[i].getBus()->readFromBus(0x2002);
+            }
+
+            CHECK(status[1] == status[0]);
+            CHECK(status[2] == status[0]);
+            seen |= status[0];
+        }
+
+        CHECK(skipped.hash() == rendered.hash());
+        CHECK(never.hash() == rendered.hash());
+    }
+
+    // The run saw vblank, sprite 0 hit and sprite overflow
+    CHECK(seen & PPUFlags::STATUS_VBLANK);
+    CHECK(seen & PPUFlags::STATUS_SPRITE0_HIT);
+    CHECK(seen & PPUFlags::STATUS_SPRITE_OVERFLOW);
+
+    CHECK(consoles[0].getPPU()->getFrameBuffer() != nullptr);
+    CHECK(consoles[2].getPPU()->getFrameBuffer() == nullptr);
+}
+
+
+/**
+ * @brief Sprite overflow is raised at dot 257 of the scanline that evaluates
+ * the overflowing row, one scanline before its sprites are drawn
+ *
+ */
+static void checkOverflowTiming(void)
+{
+    const U16 intervals[2] = { 1, PPU_RENDER_NEVER };
+
+    for(U8 i = 0; i < 2; i++)
+    {
+        RP2C02 ppu;
+        ppu.setRenderInterval(intervals[i]);
+
+        ppu.writeRegister(0x2003, 0x00);
+        for(U16 sprite = 0; sprite < 64; sprite++)
+        {
+            ppu.writeRegister(0x2004, (sprite < 9) ? INTERVAL_TEST_OVERFLOW_Y : 0xF0);
+            ppu.writeRegister(0x2004, 0x00);
+            ppu.writeRegister(0x2004, 0x00);
+            ppu.writeRegister(0x2004, static_cast<U8>(sprite * 8));
+        }
+        ppu.writeRegister(0x2001, 0x18);
+
+        // Run into the first full frame, then find the scanline that raises the flag
+        while(ppu.getScanline() != PPU_PRERENDER_SCANLINE)
+        {
+            ppu.PPU_Cycle();
+        }
+        while(ppu.getScanline() != 0)
+        {
+            ppu.PPU_Cycle();
+        }
+        while(!(ppu.readRegister(0x2002) & PPUFlags::STATUS_SPRITE_OVERFLOW) && ppu.getScanline() < PPU_VISIBLE_SCANLINES)
+        {
+            ppu.PPU_Cycle();
+        }
+
+        CHECK(ppu.getScanline() == INTERVAL_TEST_OVERFLOW_Y);
+        CHECK(ppu.getDot() == 258);
+    }
+}
+
+
+int main(void)
+{
+    checkSkipMatchesRendering();
+    checkOverflowTiming();
+
+    return testResult("renderinterval");
+}
\ No newline at end of file
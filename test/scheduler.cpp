@@ -0,0 +1,133 @@
+#include "../inc/nes.h"
+#include "../inc/scheduler.h"
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <array>
+#include <random>
+
+/* Scheduler Test Definitions */
+#define SCHEDULER_TEST_OPERATIONS           (U32)(20000)
+#define SCHEDULER_TEST_FRAMES               (U32)(60)
+#define SCHEDULER_TEST_DOTS_PER_FRAME       (U64)(341 * 262)    /* Rendering off: no skipped dot */
+#define SCHEDULER_TEST_MAX_INSTRUCTION      (U64)(8)            /* CPU cycles an instruction can overrun by */
+
+
+/**
+ * @brief Random schedule/move/cancel/pop sequences against a plain array of
+ * deadlines: events come out earliest first and never before they are due
+ *
+ */
+static void checkOrdering(void)
+{
+    constexpr U8 sources = static_cast<U8>(EventType::count);
+
+    EventScheduler scheduler;
+    std::array<U64, sources> expected;
+    expected.fill(EVENT_NEVER);
+
+    std::mt19937_64 random(31);
+    U64 now = 0;
+
+    for(U32 i = 0; i < SCHEDULER_TEST_OPERATIONS; i++)
+    {
+        EventType type = static_cast<EventType>(random() % sources);
+        U64 deadline = now + random() % 1000;
+
+        switch(random() % 4)
+        {
+            case 0:
+            case 1:
+                scheduler.schedule(type, deadline);
+                expected[static_cast<U8>(type)] = deadline;
+                break;
+            case 2:
+                scheduler.cancel(type);
+                expected[static_cast<U8>(type)] = EVENT_NEVER;
+                break;
+            case 3:
+                now += random() % 500;
+                EventType popped;
+                while(scheduler.pop(now, &popped))
+                {
+                    // Nothing else may be due earlier than the popped event
+                    U64 poppedDeadline = expected[static_cast<U8>(popped)];
+                    CHECK(poppedDeadline <= now);
+                    for(U8 source = 0; source < sources; source++)
+                    {
+                        CHECK(expected[source] >= poppedDeadline);
+                    }
+                    expected[static_cast<U8>(popped)] = EVENT_NEVER;
+                }
+                break;
+        }
+
+        U64 earliest = EVENT_NEVER;
+        for(U8 source = 0; source < sources; source++)
+        {
+            CHECK(scheduler.getDeadline(static_cast<EventType>(source)) == expected[source]);
+            earliest = (expected[source] < earliest) ? expected[source] : earliest;
+        }
+        CHECK(scheduler.getNextDeadline() == earliest);
+    }
+
+    // EVENT_NEVER cancels
+    scheduler.schedule(EventType::vblank, EVENT_NEVER);
+    CHECK(scheduler.getDeadline(EventType::vblank) == EVENT_NEVER);
+}
+
+
+/**
+ * @brief Running to each event (stepFrame) ends every frame in the same state
+ * as checking for events after every instruction (stepInstruction)
+ *
+ */
+static void checkEventDrivenFrames(void)
+{
+    std::vector<U8> rom = makeTestROM(32);
+
+    NES eventDriven;
+    NES stepped;
+    eventDriven.loadROM(rom.data(), rom.size());
+    stepped.loadROM(rom.data(), rom.size());
+
+    // APU frame IRQs (4-step mode) in the timeline too
+    eventDriven.getBus()->writeToBus(0x4017, 0x00);
+    stepped.getBus()->writeToBus(0x4017, 0x00);
+
+    StateTracker eventState(eventDriven);
+    StateTracker steppedState(stepped);
+    U64 startCycles = 0;
+
+    for(U32 frame = 0; frame < SCHEDULER_TEST_FRAMES; frame++)
+    {
+        eventDriven.stepFrame();
+
+        U64 target = stepped.getPPU()->getFrameCount() + 1;
+        while(stepped.getPPU()->getFrameCount() < target)
+        {
+            stepped.stepInstruction();
+        }
+
+        CHECK(eventDriven.getCPU()->getCycles() == stepped.getCPU()->getCycles());
+        CHECK(eventState.hash() == steppedState.hash());
+
+        // The first frame starts at power-up, not at a vblank
+        startCycles = frame ? startCycles : eventDriven.getCPU()->getCycles();
+    }
+
+    // Frames end on vblank: 341 x 262 dots each, to within one instruction
+    U64 elapsed = eventDriven.getCPU()->getCycles() - startCycles;
+    U64 expected = (SCHEDULER_TEST_FRAMES - 1) * SCHEDULER_TEST_DOTS_PER_FRAME / 3;
+    CHECK(elapsed + SCHEDULER_TEST_MAX_INSTRUCTION >= expected);
+    CHECK(elapsed <= expected + SCHEDULER_TEST_MAX_INSTRUCTION);
+}
+
+
+int main(void)
+{
+    checkOrdering();
+    checkEventDrivenFrames();
+
+    return testResult("scheduler");
+}
\ No newline at end of file
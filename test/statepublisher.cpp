@@ -0,0 +1,212 @@
+#include "../inc/nes.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define SHM_SUPPORTED
+#endif
+
+/* Publisher Test Definitions */
+#define PUBLISHER_TEST_FRAMES               (U32)(600)
+#define PUBLISHER_TEST_INTERVAL             (U16)(3)
+
+
+#ifdef SHM_SUPPORTED
+/**
+ * @brief Segment name unique to this process, so parallel runs don't collide
+ *
+ */
+static std::string segmentName(const char* suffix)
+{
+    return "/nesemu_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+
+/**
+ * @brief Current seqlock sequence number of a segment, read through a mapping of its own
+ *
+ */
+static U32 readSequence(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return 0;
+    }
+
+    void* mapping = mmap(nullptr, sizeof(SharedState), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    U32 sequence = static_cast<const SharedState*>(mapping)->sequence.load(std::memory_order_acquire);
+    munmap(mapping, sizeof(SharedState));
+    return sequence;
+}
+
+
+/**
+ * @brief Whether a segment of this name exists
+ *
+ */
+static bool segmentExists(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+
+/**
+ * @brief A reader racing the emulator only ever sees whole snapshots
+ *
+ * @details Before frame n the RAM is filled with n + 1, which is the frame count
+ * the snapshot is published with, so a torn read shows up as a RAM byte that
+ * doesn't match the snapshot's frame count.
+ */
+static void checkSeqlock(void)
+{
+    std::string name = segmentName("seqlock");
+    std::vector<U8> rom = makeTestROM(11);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+    CHECK(console.publishState(name));
+
+    StateSubscriber subscriber(name);
+    CHECK(subscriber.isOpen());
+
+    std::atomic<bool> done(false);
+    U64 reads = 0;
+    U64 torn = 0;
+    U64 backwards = 0;
+
+    std::thread reader([&]
+    {
+        std::unique_ptr<StateSnapshot> snapshot(new StateSnapshot);
+        U64 lastFrame = 0;
+
+        while(!done.load(std::memory_order_acquire))
+        {
+            if(!subscriber.read(snapshot.get()))
+            {
+                continue;
+            }
+
+            reads++;
+            backwards += (snapshot->frameCount < lastFrame);
+            lastFrame = snapshot->frameCount;
+
+            for(U16 i = 0; i < SHM_RAM_SIZE; i++)
+            {
+                if(snapshot->ram[i] != static_cast<U8>(snapshot->frameCount))
+                {
+                    torn++;
+                    break;
+                }
+            }
+        }
+    });
+
+    for(U32 frame = 0; frame < PUBLISHER_TEST_FRAMES; frame++)
+    {
+        U8 value = static_cast<U8>(console.getPPU()->getFrameCount() + 1);
+        std::fill(console.getRAM(), console.getRAM() + SHM_RAM_SIZE, value);
+        console.stepFrame();
+    }
+
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    CHECK(reads > 0);
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+
+    // A second publisher on the same segment continues the sequence instead of restarting it
+    U32 before = readSequence(name);
+    NES other;
+    other.loadROM(rom.data(), rom.size());
+    CHECK(other.publishState(name));
+    CHECK(readSequence(name) > before);
+    CHECK((readSequence(name) & 0x01) == 0);
+
+    // Only the publisher that created the segment removes it
+    other.publishState(std::string());
+    CHECK(segmentExists(name));
+    CHECK(StateSubscriber(name).isOpen());
+
+    console.publishState(std::string());
+    CHECK(!segmentExists(name));
+}
+
+
+/**
+ * @brief With frame skip, the published buffer is labelled with the frame it holds
+ *
+ */
+static void checkFrameNumber(void)
+{
+    std::string name = segmentName("frames");
+    std::vector<U8> rom = makeTestROM(12);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+    console.getPPU()->setRenderInterval(PUBLISHER_TEST_INTERVAL);
+    CHECK(console.publishState(name));
+
+    StateSubscriber subscriber(name);
+    std::unique_ptr<StateSnapshot> snapshot(new StateSnapshot);
+    U64 lastRendered = 0;
+
+    for(U32 frame = 0; frame < 4 * PUBLISHER_TEST_INTERVAL; frame++)
+    {
+        // Frames stop at vblank, before the next frame's render decision
+        console.stepFrame();
+        lastRendered = console.getPPU()->isFrameRendered() ? console.getPPU()->getFrameCount() : lastRendered;
+
+        CHECK(subscriber.read(snapshot.get()));
+        CHECK(snapshot->frameValid == (lastRendered != 0));
+        CHECK(snapshot->frameNumber == lastRendered);
+    }
+
+    CHECK(lastRendered != 0);
+
+    // Suppressed frames leave the buffer and its number alone
+    console.getPPU()->setOutputSuppressed(true);
+    for(U32 frame = 0; frame < 2 * PUBLISHER_TEST_INTERVAL; frame++)
+    {
+        console.stepFrame();
+    }
+
+    CHECK(subscriber.read(snapshot.get()));
+    CHECK(snapshot->frameNumber == lastRendered);
+
+    console.publishState(std::string());
+}
+#endif
+
+
+int main(void)
+{
+#ifdef SHM_SUPPORTED
+    checkSeqlock();
+    checkFrameNumber();
+#endif
+
+    return testResult("statepublisher");
+}
\ No newline at end of file
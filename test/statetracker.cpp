@@ -0,0 +1,134 @@
+#include "../inc/statetracker.h"
+#include "testing.h"
+
+#include <random>
+
+/* State Tracker Test Definitions */
+#define TRACKER_TEST_FRAMES                 (U32)(40)
+#define TRACKER_TEST_WRITES                 (U32)(64)      /* Random bus writes between frames */
+
+
+/**
+ * @brief Writes random bytes to internal RAM and name tables through the bus,
+ * so only the pages actually written are dirty
+ *
+ */
+static void scribble(NES& console, std::mt19937& random)
+{
+    Bus* bus = console.getBus();
+
+    for(U32 i = 0; i < TRACKER_TEST_WRITES; i++)
+    {
+        bus->writeToBus(static_cast<U16>(random() % 0x0800), static_cast<U8>(random()));
+    }
+
+    U16 vramAddr = 0x2000 + random() % 0x0F00;
+    bus->writeToBus(0x2006, static_cast<U8>(vramAddr >> 8));
+    bus->writeToBus(0x2006, static_cast<U8>(vramAddr));
+    bus->writeToBus(0x2007, static_cast<U8>(random()));
+}
+
+
+/**
+ * @brief Full save state of a console
+ *
+ */
+static std::vector<U8> saveState(NES& console)
+{
+    std::vector<U8> state(console.stateSize());
+    console.saveState(state.data(), state.size());
+    return state;
+}
+
+
+/**
+ * @brief A chain of deltas applied to a second console reproduces the first
+ * console exactly, frame after frame
+ *
+ */
+static void checkDeltaRoundTrip(void)
+{
+    std::vector<U8> rom = makeTestROM(21);
+    std::mt19937 random(21);
+
+    NES source;
+    NES replica;
+    source.loadROM(rom.data(), rom.size());
+    replica.loadROM(rom.data(), rom.size());
+
+    StateTracker sourceTracker(source);
+    StateTracker replicaTracker(replica);
+    std::vector<U8> delta;
+
+    for(U32 frame = 0; frame < TRACKER_TEST_FRAMES; frame++)
+    {
+        scribble(source, random);
+        source.stepFrame();
+
+        delta.resize(sourceTracker.saveDelta(nullptr, 0));
+        CHECK(sourceTracker.saveDelta(delta.data(), delta.size()) == delta.size());
+        CHECK(replicaTracker.loadDelta(delta.data(), delta.size()));
+
+        CHECK(replicaTracker.hash() == sourceTracker.hash());
+        CHECK(saveState(replica) == saveState(source));
+    }
+
+    // Nothing written since the last delta: only the registers travel
+    size_t empty = sourceTracker.saveDelta(nullptr, 0);
+    CHECK(empty < STATE_PAGE_SIZE);
+
+    // Truncated and foreign buffers are rejected without touching the console
+    std::vector<U8> before = saveState(replica);
+    delta.resize(sourceTracker.saveDelta(nullptr, 0));
+    sourceTracker.saveDelta(delta.data(), delta.size());
+    CHECK(!replicaTracker.loadDelta(delta.data(), delta.size() - 1));
+    delta[0] ^= 0xFF;
+    CHECK(!replicaTracker.loadDelta(delta.data(), delta.size()));
+    CHECK(saveState(replica) == before);
+}
+
+
+/**
+ * @brief The hash follows the machine state: restoring a state restores its
+ * hash, and a single written byte changes it
+ *
+ */
+static void checkHash(void)
+{
+    std::vector<U8> rom = makeTestROM(22);
+
+    NES console;
+    console.loadROM(rom.data(), rom.size());
+    StateTracker tracker(console);
+
+    for(U32 frame = 0; frame < 5; frame++)
+    {
+        console.stepFrame();
+    }
+
+    U64 hash = tracker.hash();
+    std::vector<U8> state = saveState(console);
+
+    console.getBus()->writeToBus(0x0123, static_cast<U8>(console.getRAM()[0x0123] ^ 0x01));
+    CHECK(tracker.hash() != hash);
+
+    console.stepFrame();
+    CHECK(tracker.hash() != hash);
+
+    CHECK(console.loadState(state.data(), state.size()));
+    CHECK(tracker.hash() == hash);
+
+    // A clone is the same machine
+    InstanceArena<NES>::Pointer clone = console.clone();
+    StateTracker cloneTracker(*clone);
+    CHECK(cloneTracker.hash() == hash);
+}
+
+
+int main(void)
+{
+    checkDeltaRoundTrip();
+    checkHash();
+
+    return testResult("statetracker");
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef TESTING_H
+#define TESTING_H
+
+/* Standard Headers */
+#include <cstdio>
+#include <random>
+#include <vector>
+/* Project Headers */
+#include "../inc/global.h"
+
+/* Test Definitions */
+#define TEST_ROM_PRG_BANKS                  (U8)(2)
+#define TEST_ROM_CHR_BANKS                  (U8)(1)
+#define TEST_ROM_SIZE                       (size_t)(16 + TEST_ROM_PRG_BANKS * 0x4000 + TEST_ROM_CHR_BANKS * 0x2000)
+
+
+/* Failed CHECK()s of this test program */
+static U32 testFailures = 0;
+
+/* Records a failure (with its location) instead of stopping, so every check runs */
+#define CHECK(condition) \
+    do \
+    { \
+        if(!(condition)) \
+        { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            testFailures++; \
+        } \
+    } while(0)
+
+
+/**
+ * Mapper 0 iNES image with random PRG and CHR ROM.
+ *
+ * The CPU decodes the random bytes as a program, which is all the checks need:
+ * deterministic execution that touches RAM, the PPU, the APU and the controllers.
+ */
+static inline std::vector<U8> makeTestROM(U32 seed)
+{
+    std::vector<U8> rom(TEST_ROM_SIZE, 0);
+    rom[0] = 'N';
+    rom[1] = 'E';
+    rom[2] = 'S';
+    rom[3] = 0x1A;
+    rom[4] = TEST_ROM_PRG_BANKS;
+    rom[5] = TEST_ROM_CHR_BANKS;
+
+    std::mt19937 random(seed);
+    for(size_t i = 16; i < rom.size(); i++)
+    {
+        rom[i] = static_cast<U8>(random());
+    }
+
+    return rom;
+}
+
+
+/* Exit status of the test program */
+static inline int testResult(const char* name)
+{
+    std::printf("%s: %s\n", name, testFailures ? "FAILED" : "passed");
+    return testFailures ? 1 : 0;
+}
+
+
+#endif /* TESTING_H */
\ No newline at end of file